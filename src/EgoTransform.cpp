@@ -0,0 +1,347 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "EgoTransform.h"
+
+#include <cmath>
+
+namespace
+{
+/* Row-major rotation matrix of the OSI z-y'-x'' (yaw, pitch, roll) convention */
+void RotationFromOrientation(double roll, double pitch, double yaw, double rotation[9])
+{
+    const double cr = std::cos(roll);
+    const double sr = std::sin(roll);
+    const double cp = std::cos(pitch);
+    const double sp = std::sin(pitch);
+    const double cy = std::cos(yaw);
+    const double sy = std::sin(yaw);
+    rotation[0] = cy * cp;
+    rotation[1] = cy * sp * sr - sy * cr;
+    rotation[2] = cy * sp * cr + sy * sr;
+    rotation[3] = sy * cp;
+    rotation[4] = sy * sp * sr + cy * cr;
+    rotation[5] = sy * sp * cr - cy * sr;
+    rotation[6] = -sp;
+    rotation[7] = cp * sr;
+    rotation[8] = cp * cr;
+}
+
+/* Multiplies the vectors (x[i], y[i], z[i]) with the transposed rotation matrix */
+void RotateTransposed(double* x, double* y, double* z, size_t count, const double rotation[9])
+{
+    const double r00 = rotation[0];
+    const double r01 = rotation[1];
+    const double r02 = rotation[2];
+    const double r10 = rotation[3];
+    const double r11 = rotation[4];
+    const double r12 = rotation[5];
+    const double r20 = rotation[6];
+    const double r21 = rotation[7];
+    const double r22 = rotation[8];
+    for (size_t i = 0; i < count; i++)
+    {
+        const double vx = x[i];
+        const double vy = y[i];
+        const double vz = z[i];
+        x[i] = r00 * vx + r10 * vy + r20 * vz;
+        y[i] = r01 * vx + r11 * vy + r21 * vz;
+        z[i] = r02 * vx + r12 * vy + r22 * vz;
+    }
+}
+}  // namespace
+
+bool EgoTransform::Apply(osi3::GroundTruth& ground_truth, uint64_t host_vehicle_id)
+{
+    const osi3::MovingObject* host = nullptr;
+    for (const auto& moving_object : ground_truth.moving_object())
+    {
+        if (moving_object.id().value() == host_vehicle_id)
+        {
+            host = &moving_object;
+            break;
+        }
+    }
+    if (host == nullptr)
+    {
+        return false;
+    }
+
+    const auto& host_orientation = host->base().orientation();
+    double rotation[9];
+    RotationFromOrientation(host_orientation.roll(), host_orientation.pitch(), host_orientation.yaw(), rotation);
+
+    const auto& host_position = host->base().position();
+    double origin[3] = {host_position.x(), host_position.y(), host_position.z()};
+    if (host->vehicle_attributes().has_bbcenter_to_rear())
+    {
+        const auto& to_rear = host->vehicle_attributes().bbcenter_to_rear();
+        for (int row = 0; row < 3; row++)
+        {
+            origin[row] += rotation[3 * row] * to_rear.x() + rotation[3 * row + 1] * to_rear.y() + rotation[3 * row + 2] * to_rear.z();
+        }
+    }
+
+    Gather(ground_truth);
+    Transform(origin, rotation);
+    Scatter(ground_truth);
+    return true;
+}
+
+void EgoTransform::Gather(osi3::GroundTruth& ground_truth)
+{
+    moving_count_ = ground_truth.moving_object_size();
+
+    stationary_bases_.clear();
+    for (auto& stationary_object : *ground_truth.mutable_stationary_object())
+    {
+        GatherBase(stationary_object);
+    }
+    for (auto& traffic_sign : *ground_truth.mutable_traffic_sign())
+    {
+        if (traffic_sign.has_main_sign())
+        {
+            GatherBase(*traffic_sign.mutable_main_sign());
+        }
+        for (auto& supplementary_sign : *traffic_sign.mutable_supplementary_sign())
+        {
+            GatherBase(supplementary_sign);
+        }
+    }
+    for (auto& traffic_light : *ground_truth.mutable_traffic_light())
+    {
+        GatherBase(traffic_light);
+    }
+    for (auto& road_marking : *ground_truth.mutable_road_marking())
+    {
+        GatherBase(road_marking);
+    }
+
+    points_.clear();
+    reference_line_points_.clear();
+    for (auto& lane : *ground_truth.mutable_lane())
+    {
+        if (lane.has_classification())
+        {
+            for (auto& point : *lane.mutable_classification()->mutable_centerline())
+            {
+                points_.push_back(&point);
+            }
+        }
+    }
+    for (auto& lane_boundary : *ground_truth.mutable_lane_boundary())
+    {
+        for (auto& boundary_point : *lane_boundary.mutable_boundary_line())
+        {
+            if (boundary_point.has_position())
+            {
+                points_.push_back(boundary_point.mutable_position());
+            }
+        }
+    }
+    for (auto& logical_lane_boundary : *ground_truth.mutable_logical_lane_boundary())
+    {
+        for (auto& boundary_point : *logical_lane_boundary.mutable_boundary_line())
+        {
+            if (boundary_point.has_position())
+            {
+                points_.push_back(boundary_point.mutable_position());
+            }
+        }
+    }
+    for (auto& reference_line : *ground_truth.mutable_reference_line())
+    {
+        for (auto& reference_line_point : *reference_line.mutable_poly_line())
+        {
+            if (reference_line_point.has_world_position())
+            {
+                points_.push_back(reference_line_point.mutable_world_position());
+            }
+            if (reference_line_point.has_t_axis_yaw())
+            {
+                reference_line_points_.push_back(&reference_line_point);
+            }
+        }
+    }
+
+    oriented_count_ = moving_count_ + stationary_bases_.size();
+    count_ = oriented_count_ + points_.size();
+    for (auto* array : {&px_, &py_, &pz_})
+    {
+        array->resize(count_);
+    }
+    for (auto* array : {&roll_, &pitch_, &yaw_})
+    {
+        array->resize(oriented_count_);
+    }
+    for (auto* array : {&vx_, &vy_, &vz_, &ax_, &ay_, &az_})
+    {
+        array->resize(moving_count_);
+    }
+    t_axis_yaw_.resize(reference_line_points_.size());
+
+    for (size_t i = 0; i < moving_count_; i++)
+    {
+        const auto& base = ground_truth.moving_object(static_cast<int>(i)).base();
+        px_[i] = base.position().x();
+        py_[i] = base.position().y();
+        pz_[i] = base.position().z();
+        roll_[i] = base.orientation().roll();
+        pitch_[i] = base.orientation().pitch();
+        yaw_[i] = base.orientation().yaw();
+        vx_[i] = base.velocity().x();
+        vy_[i] = base.velocity().y();
+        vz_[i] = base.velocity().z();
+        ax_[i] = base.acceleration().x();
+        ay_[i] = base.acceleration().y();
+        az_[i] = base.acceleration().z();
+    }
+    for (size_t i = moving_count_; i < oriented_count_; i++)
+    {
+        const osi3::BaseStationary& base = *stationary_bases_[i - moving_count_];
+        px_[i] = base.position().x();
+        py_[i] = base.position().y();
+        pz_[i] = base.position().z();
+        roll_[i] = base.orientation().roll();
+        pitch_[i] = base.orientation().pitch();
+        yaw_[i] = base.orientation().yaw();
+    }
+    for (size_t i = oriented_count_; i < count_; i++)
+    {
+        const osi3::Vector3d& point = *points_[i - oriented_count_];
+        px_[i] = point.x();
+        py_[i] = point.y();
+        pz_[i] = point.z();
+    }
+    for (size_t i = 0; i < reference_line_points_.size(); i++)
+    {
+        t_axis_yaw_[i] = reference_line_points_[i]->t_axis_yaw();
+    }
+}
+
+void EgoTransform::Transform(const double origin[3], const double rotation[9])
+{
+    double* const px = px_.data();
+    double* const py = py_.data();
+    double* const pz = pz_.data();
+    for (size_t i = 0; i < count_; i++)
+    {
+        px[i] -= origin[0];
+        py[i] -= origin[1];
+        pz[i] -= origin[2];
+    }
+    RotateTransposed(px, py, pz, count_, rotation);
+    RotateTransposed(vx_.data(), vy_.data(), vz_.data(), moving_count_, rotation);
+    RotateTransposed(ax_.data(), ay_.data(), az_.data(), moving_count_, rotation);
+
+    const double r00 = rotation[0];
+    const double r01 = rotation[1];
+    const double r02 = rotation[2];
+    const double r10 = rotation[3];
+    const double r11 = rotation[4];
+    const double r12 = rotation[5];
+    const double r20 = rotation[6];
+    const double r21 = rotation[7];
+    const double r22 = rotation[8];
+
+    /* Relative orientation is the transposed host rotation times the object rotation */
+    double* const roll = roll_.data();
+    double* const pitch = pitch_.data();
+    double* const yaw = yaw_.data();
+    for (size_t i = 0; i < oriented_count_; i++)
+    {
+        const double cr = std::cos(roll[i]);
+        const double sr = std::sin(roll[i]);
+        const double cp = std::cos(pitch[i]);
+        const double sp = std::sin(pitch[i]);
+        const double cy = std::cos(yaw[i]);
+        const double sy = std::sin(yaw[i]);
+        const double o00 = cy * cp;
+        const double o10 = sy * cp;
+        const double o20 = -sp;
+        const double o01 = cy * sp * sr - sy * cr;
+        const double o11 = sy * sp * sr + cy * cr;
+        const double o21 = cp * sr;
+        const double o02 = cy * sp * cr + sy * sr;
+        const double o12 = sy * sp * cr - cy * sr;
+        const double o22 = cp * cr;
+        const double m00 = r00 * o00 + r10 * o10 + r20 * o20;
+        const double m10 = r01 * o00 + r11 * o10 + r21 * o20;
+        const double m20 = r02 * o00 + r12 * o10 + r22 * o20;
+        const double m21 = r02 * o01 + r12 * o11 + r22 * o21;
+        const double m22 = r02 * o02 + r12 * o12 + r22 * o22;
+        yaw[i] = std::atan2(m10, m00);
+        pitch[i] = std::atan2(-m20, std::sqrt(m00 * m00 + m10 * m10));
+        roll[i] = std::atan2(m21, m22);
+    }
+
+    /* T axes of reference lines lie in the global x-y plane; their direction
+     * is rotated and projected onto the x-y plane of the host */
+    for (double& t_axis_yaw : t_axis_yaw_)
+    {
+        const double dx = std::cos(t_axis_yaw);
+        const double dy = std::sin(t_axis_yaw);
+        t_axis_yaw = std::atan2(r01 * dx + r11 * dy, r00 * dx + r10 * dy);
+    }
+}
+
+void EgoTransform::Scatter(osi3::GroundTruth& ground_truth) const
+{
+    for (size_t i = 0; i < moving_count_; i++)
+    {
+        auto* const base = ground_truth.mutable_moving_object(static_cast<int>(i))->mutable_base();
+        if (base->has_position())
+        {
+            base->mutable_position()->set_x(px_[i]);
+            base->mutable_position()->set_y(py_[i]);
+            base->mutable_position()->set_z(pz_[i]);
+        }
+        if (base->has_orientation())
+        {
+            base->mutable_orientation()->set_roll(roll_[i]);
+            base->mutable_orientation()->set_pitch(pitch_[i]);
+            base->mutable_orientation()->set_yaw(yaw_[i]);
+        }
+        if (base->has_velocity())
+        {
+            base->mutable_velocity()->set_x(vx_[i]);
+            base->mutable_velocity()->set_y(vy_[i]);
+            base->mutable_velocity()->set_z(vz_[i]);
+        }
+        if (base->has_acceleration())
+        {
+            base->mutable_acceleration()->set_x(ax_[i]);
+            base->mutable_acceleration()->set_y(ay_[i]);
+            base->mutable_acceleration()->set_z(az_[i]);
+        }
+    }
+    for (size_t i = moving_count_; i < oriented_count_; i++)
+    {
+        osi3::BaseStationary* const base = stationary_bases_[i - moving_count_];
+        if (base->has_position())
+        {
+            base->mutable_position()->set_x(px_[i]);
+            base->mutable_position()->set_y(py_[i]);
+            base->mutable_position()->set_z(pz_[i]);
+        }
+        if (base->has_orientation())
+        {
+            base->mutable_orientation()->set_roll(roll_[i]);
+            base->mutable_orientation()->set_pitch(pitch_[i]);
+            base->mutable_orientation()->set_yaw(yaw_[i]);
+        }
+    }
+    for (size_t i = oriented_count_; i < count_; i++)
+    {
+        osi3::Vector3d* const point = points_[i - oriented_count_];
+        point->set_x(px_[i]);
+        point->set_y(py_[i]);
+        point->set_z(pz_[i]);
+    }
+    for (size_t i = 0; i < reference_line_points_.size(); i++)
+    {
+        reference_line_points_[i]->set_t_axis_yaw(t_axis_yaw_[i]);
+    }
+}
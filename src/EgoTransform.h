@@ -0,0 +1,63 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+#ifndef EgoTransform_H_
+#define EgoTransform_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "osi_groundtruth.pb.h"
+
+/*
+ * Ego Frame Transformation
+ *
+ * Rewrites all geometry of a GroundTruth from global coordinates into the
+ * vehicle coordinate system of the host vehicle, i.e. the origin is moved to
+ * the center of the host's rear axle and the axes are rotated by the host's
+ * orientation.  This covers the poses of moving and stationary objects,
+ * traffic signs, traffic lights and road markings as well as the points of
+ * lanes, lane boundaries, logical lane boundaries and reference lines.
+ * Velocities and accelerations keep their absolute values but are expressed
+ * in the host's axes.
+ *
+ * Positions, orientations and motion are copied into a structure of arrays,
+ * ordered moving objects first, then stationary bases, then plain points, so
+ * the transformation runs as plain loops over contiguous doubles which the
+ * compiler vectorizes.  The arrays are kept between calls to avoid
+ * allocations during playback.
+ */
+class EgoTransform
+{
+  public:
+    /* Returns false if the host vehicle is not part of the moving objects */
+    bool Apply(osi3::GroundTruth& ground_truth, uint64_t host_vehicle_id);
+
+  private:
+    template <typename T>
+    void GatherBase(T& element)
+    {
+        if (element.has_base())
+        {
+            stationary_bases_.push_back(element.mutable_base());
+        }
+    }
+    void Gather(osi3::GroundTruth& ground_truth);
+    void Scatter(osi3::GroundTruth& ground_truth) const;
+    void Transform(const double origin[3], const double rotation[9]);
+
+    size_t moving_count_ = 0;
+    size_t oriented_count_ = 0;
+    size_t count_ = 0;
+    std::vector<osi3::BaseStationary*> stationary_bases_;
+    std::vector<osi3::Vector3d*> points_;
+    std::vector<osi3::ReferenceLine::ReferenceLinePoint*> reference_line_points_;
+    std::vector<double> px_, py_, pz_;
+    std::vector<double> roll_, pitch_, yaw_;
+    std::vector<double> vx_, vy_, vz_;
+    std::vector<double> ax_, ay_, az_;
+    std::vector<double> t_axis_yaw_;
+};
+
+#endif
@@ -0,0 +1,159 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "FrameHash.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <string>
+
+namespace
+{
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t RotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Read64(const unsigned char* p)
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t Read32(const unsigned char* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t Round(uint64_t accumulator, uint64_t input)
+{
+    accumulator += input * kPrime2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t accumulator, uint64_t lane)
+{
+    accumulator ^= Round(0, lane);
+    return accumulator * kPrime1 + kPrime4;
+}
+}  // namespace
+
+uint64_t FrameHash(const void* data, size_t length)
+{
+    const auto* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const end = p + length;
+    uint64_t hash;
+
+    if (length >= 32)
+    {
+        uint64_t v1 = kPrime1 + kPrime2;
+        uint64_t v2 = kPrime2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - kPrime1;
+        const unsigned char* const limit = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = kPrime5;
+    }
+    hash += static_cast<uint64_t>(length);
+
+    for (; p + 8 <= end; p += 8)
+    {
+        hash ^= Round(0, Read64(p));
+        hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(Read32(p)) * kPrime1;
+        hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+    {
+        hash ^= static_cast<uint64_t>(*p) * kPrime5;
+        hash = RotateLeft(hash, 11) * kPrime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bool ReadFrameHashes(const std::filesystem::path& path, std::vector<uint64_t>& hashes)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+    hashes.clear();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        size_t parsed = 0;
+        try
+        {
+            hashes.push_back(std::stoull(line, &parsed, 16));
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        if (parsed != line.find_last_not_of(" \t\r") + 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WriteFrameHashes(const std::filesystem::path& path, const std::vector<uint64_t>& hashes)
+{
+    FILE* file = std::fopen(path.string().c_str(), "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    for (const uint64_t hash : hashes)
+    {
+        std::fprintf(file, "%016" PRIx64 "\n", hash);
+    }
+    return std::fclose(file) == 0;
+}
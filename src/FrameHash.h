@@ -0,0 +1,30 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+#ifndef FrameHash_H_
+#define FrameHash_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/*
+ * Frame Hashes
+ *
+ * FrameHash() computes the 64 bit xxHash (XXH64, seed 0) of a published
+ * buffer.  XXH64 processes four independent 64 bit lanes per 32 byte stripe,
+ * which compilers keep in registers and pipeline well, so hashing a 10 MB
+ * frame takes around a millisecond.  The digests are identical to those of
+ * the reference implementation, e.g. `xxh64sum`, on little-endian machines.
+ *
+ * A frame hash list holds one digest per published frame as 16 hexadecimal
+ * digits per line.  It is stored beside a trace as `<trace file>.xxh64`.
+ */
+uint64_t FrameHash(const void* data, size_t length);
+
+bool ReadFrameHashes(const std::filesystem::path& path, std::vector<uint64_t>& hashes);
+bool WriteFrameHashes(const std::filesystem::path& path, const std::vector<uint64_t>& hashes);
+
+#endif
@@ -0,0 +1,196 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "FrameInterpolator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double kTwoPi = 6.283185307179586;
+
+/* Finalizer of splitmix64, spreads sequential ids over the table */
+uint64_t MixId(uint64_t id)
+{
+    id = (id ^ (id >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    id = (id ^ (id >> 27U)) * 0x94D049BB133111EBULL;
+    return id ^ (id >> 31U);
+}
+}  // namespace
+
+void FrameInterpolator::Prepare(const osi3::GroundTruth& previous, const osi3::GroundTruth* next)
+{
+    count_ = previous.moving_object_size();
+    for (int component = 0; component < kComponentCount; component++)
+    {
+        from_[component].resize(count_);
+        delta_[component].resize(count_);
+        result_[component].resize(count_);
+    }
+
+    for (size_t i = 0; i < count_; i++)
+    {
+        Store(from_, i, previous.moving_object(static_cast<int>(i)).base());
+    }
+
+    if (next == nullptr)
+    {
+        for (auto& delta : delta_)
+        {
+            std::fill(delta.begin(), delta.end(), 0.0);
+        }
+        return;
+    }
+
+    /* The target values are stored in delta_ first and turned into
+     * differences below */
+    IndexObjects(*next);
+    for (size_t i = 0; i < count_; i++)
+    {
+        const int match = FindObject(previous.moving_object(static_cast<int>(i)).id().value());
+        if (match >= 0)
+        {
+            Store(delta_, i, next->moving_object(match).base());
+        }
+        else
+        {
+            for (int component = 0; component < kComponentCount; component++)
+            {
+                delta_[component][i] = from_[component][i];
+            }
+        }
+    }
+    for (int component = 0; component < kComponentCount; component++)
+    {
+        const double* const from = from_[component].data();
+        double* const delta = delta_[component].data();
+        for (size_t i = 0; i < count_; i++)
+        {
+            delta[i] -= from[i];
+        }
+    }
+    for (int component = kRoll; component <= kYaw; component++)
+    {
+        for (double& delta : delta_[component])
+        {
+            delta = std::remainder(delta, kTwoPi);
+        }
+    }
+}
+
+void FrameInterpolator::Apply(osi3::GroundTruth& previous, double alpha)
+{
+    for (int component = 0; component < kComponentCount; component++)
+    {
+        const double* const from = from_[component].data();
+        const double* const delta = delta_[component].data();
+        double* const result = result_[component].data();
+        for (size_t i = 0; i < count_; i++)
+        {
+            result[i] = from[i] + alpha * delta[i];
+        }
+    }
+    for (int component = kRoll; component <= kYaw; component++)
+    {
+        for (double& angle : result_[component])
+        {
+            angle = std::remainder(angle, kTwoPi);
+        }
+    }
+
+    for (size_t i = 0; i < count_; i++)
+    {
+        auto* const base = previous.mutable_moving_object(static_cast<int>(i))->mutable_base();
+        if (base->has_position())
+        {
+            base->mutable_position()->set_x(result_[kPositionX][i]);
+            base->mutable_position()->set_y(result_[kPositionY][i]);
+            base->mutable_position()->set_z(result_[kPositionZ][i]);
+        }
+        if (base->has_velocity())
+        {
+            base->mutable_velocity()->set_x(result_[kVelocityX][i]);
+            base->mutable_velocity()->set_y(result_[kVelocityY][i]);
+            base->mutable_velocity()->set_z(result_[kVelocityZ][i]);
+        }
+        if (base->has_acceleration())
+        {
+            base->mutable_acceleration()->set_x(result_[kAccelerationX][i]);
+            base->mutable_acceleration()->set_y(result_[kAccelerationY][i]);
+            base->mutable_acceleration()->set_z(result_[kAccelerationZ][i]);
+        }
+        if (base->has_orientation())
+        {
+            base->mutable_orientation()->set_roll(result_[kRoll][i]);
+            base->mutable_orientation()->set_pitch(result_[kPitch][i]);
+            base->mutable_orientation()->set_yaw(result_[kYaw][i]);
+        }
+    }
+}
+
+void FrameInterpolator::IndexObjects(const osi3::GroundTruth& next)
+{
+    size_t capacity = 16;
+    while (capacity < 2 * static_cast<size_t>(next.moving_object_size()))
+    {
+        capacity <<= 1U;
+    }
+    slot_ids_.assign(capacity, 0);
+    slot_indices_.assign(capacity, -1);
+    slot_mask_ = capacity - 1;
+
+    for (int i = 0; i < next.moving_object_size(); i++)
+    {
+        const uint64_t id = next.moving_object(i).id().value();
+        size_t slot = MixId(id) & slot_mask_;
+        while (slot_indices_[slot] >= 0 && slot_ids_[slot] != id)
+        {
+            slot = (slot + 1) & slot_mask_;
+        }
+        slot_ids_[slot] = id;
+        slot_indices_[slot] = i;
+    }
+}
+
+size_t FrameInterpolator::MemoryUsage() const
+{
+    size_t usage = slot_ids_.capacity() * sizeof(uint64_t) + slot_indices_.capacity() * sizeof(int);
+    for (int component = 0; component < kComponentCount; component++)
+    {
+        usage += (from_[component].capacity() + delta_[component].capacity() + result_[component].capacity()) * sizeof(double);
+    }
+    return usage;
+}
+
+int FrameInterpolator::FindObject(uint64_t id) const
+{
+    size_t slot = MixId(id) & slot_mask_;
+    while (slot_indices_[slot] >= 0)
+    {
+        if (slot_ids_[slot] == id)
+        {
+            return slot_indices_[slot];
+        }
+        slot = (slot + 1) & slot_mask_;
+    }
+    return -1;
+}
+
+void FrameInterpolator::Store(Components& components, size_t index, const osi3::BaseMoving& base)
+{
+    components[kPositionX][index] = base.position().x();
+    components[kPositionY][index] = base.position().y();
+    components[kPositionZ][index] = base.position().z();
+    components[kVelocityX][index] = base.velocity().x();
+    components[kVelocityY][index] = base.velocity().y();
+    components[kVelocityZ][index] = base.velocity().z();
+    components[kAccelerationX][index] = base.acceleration().x();
+    components[kAccelerationY][index] = base.acceleration().y();
+    components[kAccelerationZ][index] = base.acceleration().z();
+    components[kRoll][index] = base.orientation().roll();
+    components[kPitch][index] = base.orientation().pitch();
+    components[kYaw][index] = base.orientation().yaw();
+}
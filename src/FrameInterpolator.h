@@ -0,0 +1,68 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+#ifndef FrameInterpolator_H_
+#define FrameInterpolator_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "osi_groundtruth.pb.h"
+
+/*
+ * Frame Interpolation
+ *
+ * Linearly interpolates the poses, velocities and accelerations of the
+ * moving objects between two consecutive GroundTruth frames.  Objects are
+ * matched by id through an open-addressing hash table; objects missing in
+ * the next frame keep their values.  Angles are interpolated along the
+ * shorter arc and wrapped to [-pi, pi].
+ *
+ * Prepare() is called once per pair of frames and stores the values of the
+ * previous frame together with the differences to the next frame as a
+ * structure of arrays.  Apply() then only evaluates a single vectorizable
+ * loop and writes the result back into the previous frame, so the previous
+ * frame doubles as output message and no memory is allocated per step.
+ */
+class FrameInterpolator
+{
+  public:
+    void Prepare(const osi3::GroundTruth& previous, const osi3::GroundTruth* next);
+    void Apply(osi3::GroundTruth& previous, double alpha);
+    size_t MemoryUsage() const;
+
+  private:
+    enum Component
+    {
+        kPositionX,
+        kPositionY,
+        kPositionZ,
+        kVelocityX,
+        kVelocityY,
+        kVelocityZ,
+        kAccelerationX,
+        kAccelerationY,
+        kAccelerationZ,
+        kRoll,
+        kPitch,
+        kYaw,
+        kComponentCount
+    };
+    using Components = std::array<std::vector<double>, kComponentCount>;
+
+    void IndexObjects(const osi3::GroundTruth& next);
+    int FindObject(uint64_t id) const;
+    static void Store(Components& components, size_t index, const osi3::BaseMoving& base);
+
+    size_t count_ = 0;
+    Components from_;
+    Components delta_;
+    Components result_;
+    std::vector<uint64_t> slot_ids_;
+    std::vector<int> slot_indices_;
+    size_t slot_mask_ = 0;
+};
+
+#endif
@@ -44,10 +44,18 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
+#include <cinttypes>
 #include <cmath>
 #include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
 #include <string>
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
 using namespace std;
 
 #ifdef PRIVATE_LOG_PATH_TRACE_FILE_PLAYER
@@ -103,64 +111,929 @@ void EncodePointerToInteger(const void* ptr, fmi2Integer& hi, fmi2Integer& lo)
 #endif
 }
 
-void COSMPTraceFilePlayer::SetFmiSensorViewOut(const osi3::SensorView& data)
+template <typename T>
+void COSMPTraceFilePlayer::SerializeToBuffer(const T& data)
 {
     data.SerializeToString(current_buffer_);
-    EncodePointerToInteger(current_buffer_->data(), integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX]);
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] = static_cast<fmi2Integer>(current_buffer_->length());
-    NormalLog("OSMP",
-              "Providing %08X %08X, writing from %p ...",
-              integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX],
-              integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX],
-              current_buffer_->data());
-    swap(current_buffer_, last_buffer_);
 }
 
-void COSMPTraceFilePlayer::SetFmiSensorDataOut(const osi3::SensorData& data)
+void COSMPTraceFilePlayer::SerializeToBuffer(osi3::SensorView& data)
 {
-    data.SerializeToString(current_buffer_);
-    EncodePointerToInteger(current_buffer_->data(), integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX]);
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] = static_cast<fmi2Integer>(current_buffer_->length());
-    NormalLog("OSMP",
-              "Providing %08X %08X, writing from %p ...",
-              integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX],
-              integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX],
-              current_buffer_->data());
+    if ((CacheStaticContent() || !shared_trace_state_->static_prefix.empty()) && data.has_global_ground_truth())
+    {
+        osi3::GroundTruth* const ground_truth = data.release_global_ground_truth();
+        data.SerializeToString(current_buffer_);
+        AppendGroundTruth(*ground_truth, current_buffer_, osi3::SensorView::kGlobalGroundTruthFieldNumber);
+        data.set_allocated_global_ground_truth(ground_truth);
+    }
+    else
+    {
+        data.SerializeToString(current_buffer_);
+    }
+}
+
+void COSMPTraceFilePlayer::SerializeToBuffer(osi3::GroundTruth& data)
+{
+    if (FmiSynthesizeSensorView())
+    {
+        /* The GroundTruth is serialized directly behind the preallocated
+         * SensorView as its global_ground_truth field instead of being copied
+         * into the SensorView message. */
+        synthesized_sensor_view_.mutable_version()->CopyFrom(data.version());
+        synthesized_sensor_view_.mutable_timestamp()->CopyFrom(data.timestamp());
+        synthesized_sensor_view_.mutable_host_vehicle_id()->CopyFrom(data.host_vehicle_id());
+        synthesized_sensor_view_.SerializeToString(current_buffer_);
+        AppendGroundTruth(data, current_buffer_, osi3::SensorView::kGlobalGroundTruthFieldNumber);
+    }
+    else
+    {
+        current_buffer_->clear();
+        AppendGroundTruth(data, current_buffer_, 0);
+    }
+}
+
+void COSMPTraceFilePlayer::PublishBuffer(int base_lo_idx, int base_hi_idx, int size_idx)
+{
+    EncodePointerToInteger(current_buffer_->data(), integer_vars_[base_hi_idx], integer_vars_[base_lo_idx]);
+    integer_vars_[size_idx] = static_cast<fmi2Integer>(current_buffer_->length());
+    NormalLog("OSMP", "Providing %08X %08X, writing from %p ...", integer_vars_[base_hi_idx], integer_vars_[base_lo_idx], current_buffer_->data());
     swap(current_buffer_, last_buffer_);
 }
 
-void COSMPTraceFilePlayer::ResetFmiSensorViewOut()
+void COSMPTraceFilePlayer::ResetSynthesizedSensorView()
 {
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] = 0;
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX] = 0;
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX] = 0;
+    synthesized_sensor_view_.Clear();
+    auto* const mounting_position = synthesized_sensor_view_.mutable_mounting_position();
+    mounting_position->mutable_position()->set_x(FmiMountingPositionX());
+    mounting_position->mutable_position()->set_y(FmiMountingPositionY());
+    mounting_position->mutable_position()->set_z(FmiMountingPositionZ());
+    mounting_position->mutable_orientation()->set_roll(FmiMountingPositionRoll());
+    mounting_position->mutable_orientation()->set_pitch(FmiMountingPositionPitch());
+    mounting_position->mutable_orientation()->set_yaw(FmiMountingPositionYaw());
 }
 
-void COSMPTraceFilePlayer::ResetFmiSensorDataOut()
+/*
+ * Delta-compressed Traces
+ */
+
+bool COSMPTraceFilePlayer::LoadStaticPrefix(const std::filesystem::path& static_trace_path, string& static_prefix)
 {
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] = 0;
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX] = 0;
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX] = 0;
+    auto static_reader = osi3::TraceFileReaderFactory::createReader(static_trace_path);
+    if (!static_reader || !static_reader->Open(static_trace_path))
+    {
+        std::cerr << "Could not open static trace file " << static_trace_path.string() << std::endl;
+        return false;
+    }
+
+    const auto reading_result = static_reader->ReadMessage();
+    static_reader->Close();
+    if (!reading_result || reading_result->message_type != osi3::ReaderTopLevelMessage::kGroundTruth)
+    {
+        std::cerr << "Static trace file " << static_trace_path.string() << " does not start with a GroundTruth message" << std::endl;
+        return false;
+    }
+
+    reading_result->message->SerializeToString(&static_prefix);
+    return true;
 }
 
-void COSMPTraceFilePlayer::SetFmiGroundTruthOut(const osi3::GroundTruth& data)
+/*
+ * Shared Trace State
+ *
+ * Masters running parameter sweeps instantiate the player many times with
+ * the same trace.  The immutable data derived from the trace files (the
+ * static GroundTruth prefix and the frame hash list) is therefore loaded
+ * once per process and shared by all instances with the same trace, static
+ * trace and file versions.  Nothing else is shared: every instance opens
+ * the trace, reads its metadata and locates, reads and decodes its records
+ * through its own reader, so instances without static trace and frame hash
+ * list share nothing but an empty state.  The registry only holds weak references, so the data is freed
+ * with the last instance using it.  Instances opening the same
+ * configuration concurrently wait for the first one to load it.
+ */
+
+namespace
 {
-    data.SerializeToString(current_buffer_);
-    EncodePointerToInteger(current_buffer_->data(), integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX], integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX]);
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] = static_cast<fmi2Integer>(current_buffer_->length());
-    NormalLog("OSMP",
-              "Providing %08X %08X, writing from %p ...",
-              integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX],
-              integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX],
-              current_buffer_->data());
-    swap(current_buffer_, last_buffer_);
+void AppendFileSignature(const std::filesystem::path& path, string& key)
+{
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    const auto modified = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    key += path.string();
+    key += '\n';
+    key += std::to_string(error ? 0 : size);
+    key += '\n';
+    key += std::to_string(error ? 0 : modified);
+    key += '\n';
+}
+}  // namespace
+
+std::shared_ptr<const COSMPTraceFilePlayer::SharedTraceState> COSMPTraceFilePlayer::AcquireSharedTraceState(const std::filesystem::path& trace_path,
+                                                                                                           const std::filesystem::path& static_trace_path)
+{
+    struct RegistryEntry
+    {
+        std::mutex mutex;
+        std::weak_ptr<const SharedTraceState> state;
+    };
+    static std::mutex registry_mutex;
+    static std::map<string, std::shared_ptr<RegistryEntry>> registry;
+
+    std::filesystem::path hash_path = trace_path;
+    hash_path += ".xxh64";
+    string key;
+    AppendFileSignature(trace_path, key);
+    AppendFileSignature(hash_path, key);
+    if (!static_trace_path.empty())
+    {
+        AppendFileSignature(static_trace_path, key);
+    }
+
+    std::shared_ptr<RegistryEntry> entry;
+    {
+        const std::lock_guard<std::mutex> lock(registry_mutex);
+        for (auto it = registry.begin(); it != registry.end();)
+        {
+            it = it->second.use_count() == 1 && it->second->state.expired() ? registry.erase(it) : std::next(it);
+        }
+        auto& registered = registry[key];
+        if (!registered)
+        {
+            registered = std::make_shared<RegistryEntry>();
+        }
+        entry = registered;
+    }
+
+    const std::lock_guard<std::mutex> lock(entry->mutex);
+    if (auto state = entry->state.lock())
+    {
+        return state;
+    }
+
+    auto state = std::make_shared<SharedTraceState>();
+    if (!static_trace_path.empty() && !LoadStaticPrefix(static_trace_path, state->static_prefix))
+    {
+        return nullptr;
+    }
+    if (std::filesystem::exists(hash_path) && !ReadFrameHashes(hash_path, state->frame_hashes))
+    {
+        std::cerr << "Could not read frame hash list " << hash_path.string() << ", frames are not verified" << std::endl;
+        state->frame_hashes.clear();
+    }
+    entry->state = state;
+    return state;
+}
+
+/*
+ * Trace Opening
+ *
+ * Discovering, creating and opening the trace (including the summary
+ * sections of MCAP files) can take seconds on network file systems.  It is
+ * therefore started asynchronously when initialization mode is exited, where
+ * the trace parameters and the worker placement, which is applied to the
+ * opening thread, are final, and only the first DoCalc waits for it to
+ * complete.  Opening on every parameter change instead would start opens
+ * which are superseded and still have to be waited for.  OpenTrace() reports
+ * all failures, including exceptions, as an OpenedTrace without reader, so
+ * that nothing is thrown through the FMI functions which wait for it.
+ */
+
+COSMPTraceFilePlayer::OpenedTrace COSMPTraceFilePlayer::OpenTrace(const std::filesystem::path& folder_path,
+                                                                  const string& trace_name,
+                                                                  const string& static_trace_name,
+                                                                  const ThreadPlacement& placement)
+{
+    try
+    {
+        return OpenTraceFiles(folder_path, trace_name, static_trace_name, placement);
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "Could not open trace in " << folder_path.string() << ": " << error.what() << std::endl;
+        return {};
+    }
+}
+
+COSMPTraceFilePlayer::OpenedTrace COSMPTraceFilePlayer::OpenTraceFiles(const std::filesystem::path& folder_path,
+                                                                       const string& trace_name,
+                                                                       const string& static_trace_name,
+                                                                       const ThreadPlacement& placement)
+{
+    const auto start = std::chrono::steady_clock::now();
+    if (!placement.ApplyToCurrentThread())
+    {
+        std::cerr << "Could not apply worker placement " << placement.Describe() << " to trace opening thread" << std::endl;
+    }
+    OpenedTrace opened;
+
+    const std::filesystem::path trace_file_name = trace_name.empty() ? FindTraceFile(folder_path) : std::filesystem::path(trace_name);
+    if (trace_file_name.empty())
+    {
+        std::cerr << "No trace file found in " << folder_path.string() << std::endl;
+        return opened;
+    }
+
+    const std::filesystem::path trace_path = folder_path / trace_file_name;
+    opened.shared_state = AcquireSharedTraceState(trace_path, static_trace_name.empty() ? std::filesystem::path() : folder_path / static_trace_name);
+    if (!opened.shared_state)
+    {
+        return opened;
+    }
+
+    auto reader = osi3::TraceFileReaderFactory::createReader(trace_path);
+    if (!reader || !reader->Open(trace_path))
+    {
+        std::cerr << "Could not open trace file " << trace_path.string() << std::endl;
+        return opened;
+    }
+
+    opened.reader = std::move(reader);
+    opened.trace_path = trace_path;
+    opened.open_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return opened;
+}
+
+void COSMPTraceFilePlayer::StartTraceOpen()
+{
+    pending_trace_ = std::async(std::launch::async,
+                                &COSMPTraceFilePlayer::OpenTrace,
+                                std::filesystem::path(FmiTracePath()),
+                                FmiTraceName(),
+                                FmiStaticTraceName(),
+                                ThreadPlacement::FromParameters(FmiWorkerCpus(), FmiWorkerNumaNode()));
+}
+
+namespace
+{
+constexpr fmi2Integer kOnCorruptRecordAbort = 0;
+constexpr fmi2Integer kOnCorruptRecordHold = 2;
+}  // namespace
+
+bool COSMPTraceFilePlayer::AwaitTraceOpen()
+{
+    if (!pending_trace_.valid())
+    {
+        return trace_file_reader_ != nullptr;
+    }
+
+    OpenedTrace opened = pending_trace_.get();
+    if (!opened.reader)
+    {
+        return false;
+    }
+    if (FmiEgoCoordinates() && !opened.shared_state->static_prefix.empty())
+    {
+        std::cerr << "Static GroundTruth of delta-compressed traces is serialized once and cannot be transformed into ego coordinates" << std::endl;
+        return false;
+    }
+
+    ResetTraceReader();
+    trace_file_reader_ = std::move(opened.reader);
+    trace_file_path_ = opened.trace_path;
+    if (FmiOnCorruptRecord() != kOnCorruptRecordAbort || CacheStaticContent())
+    {
+        UseRecordReader();
+    }
+    trace_readahead_.Open(opened.trace_path, FmiDropPlayedPages());
+    shared_trace_state_ = std::move(opened.shared_state);
+    SetFmiTraceOpenTime(opened.open_time);
+    NormalLog("OSI", "Opened trace in %g s, static GroundTruth prefix of %zu bytes", opened.open_time, shared_trace_state_->static_prefix.size());
+    return true;
+}
+
+/*
+ * Trace Readahead
+ *
+ * All messages are read through ReadRecord(), which feeds the consumed bytes
+ * to the readahead and counts stalls, i.e. reads which had to wait for
+ * storage.  The record reader of .osi traces reports the time spent in file
+ * reads alone, which is a stall if it exceeds kReadStallThreshold.  Other
+ * readers also decode and decompress within ReadMessage(), so their reads
+ * stall only if they exceed kReadStallThreshold in addition to twice the
+ * time the fastest read so far would have needed per byte.  For MCAP traces
+ * the consumed bytes are estimated from the uncompressed message sizes.
+ */
+
+namespace
+{
+constexpr auto kReadStallThreshold = std::chrono::milliseconds(1);
+constexpr size_t kOsiRecordSizeLength = 4;
+}  // namespace
+
+std::optional<osi3::ReadResult> COSMPTraceFilePlayer::ReadRecord()
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto frame = trace_file_reader_->ReadMessage();
+    const auto read_time = std::chrono::steady_clock::now() - start;
+    /* Without the record reader, the record length is taken from the
+     * encoded size of the message, which is computed only once */
+    const size_t encoded_size = frame && trace_record_reader_ == nullptr ? frame->message->ByteSizeLong() : 0;
+    bool stalled = false;
+    if (trace_record_reader_ != nullptr)
+    {
+        stalled = trace_record_reader_->LastReadTime() > kReadStallThreshold;
+    }
+    else
+    {
+        const double message_size = static_cast<double>(encoded_size);
+        const double read_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(read_time).count());
+        const double decode_ns = 2.0 * message_size * fastest_read_ns_per_byte_;
+        stalled = read_ns > static_cast<double>(std::chrono::nanoseconds(kReadStallThreshold).count()) + decode_ns;
+        if (message_size > 0.0 && (fastest_read_ns_per_byte_ == 0.0 || read_ns < message_size * fastest_read_ns_per_byte_))
+        {
+            fastest_read_ns_per_byte_ = read_ns / message_size;
+        }
+    }
+    if (stalled)
+    {
+        SetFmiReadStalls(FmiReadStalls() + 1);
+    }
+    read_static_digest_ = kNoStaticContentDigest;
+    if (!frame)
+    {
+        return frame;
+    }
+    last_message_type_ = frame->message_type;
+    if (CacheStaticContent())
+    {
+        read_static_digest_ = StaticContentDigest(frame->message_type);
+    }
+    if (trace_readahead_.IsOpen() || FmiOnCorruptRecord() != kOnCorruptRecordAbort)
+    {
+        const uint64_t record_size = trace_record_reader_ != nullptr ? trace_record_reader_->Offset() - consumed_offset_
+                                                                     : kOsiRecordSizeLength + encoded_size;
+        consumed_offset_ += record_size;
+        trace_readahead_.Advance(record_size, stalled);
+        SetFmiReadaheadKib(static_cast<fmi2Integer>(trace_readahead_.ReadaheadBytes() >> 10));
+    }
+    return frame;
+}
+
+/*
+ * Corrupt Records
+ *
+ * Depending on on_corrupt_record, a record which cannot be read aborts the
+ * simulation, is skipped, or is skipped while the last good frame is held
+ * for the current step.  Unless corrupt records abort, .osi traces are read
+ * from the start by an own record reader, so the offset of every record is
+ * known exactly; on a corrupt record it resynchronizes to the next valid one
+ * by scanning forward.  Only if the message type cannot be taken from the
+ * file name, the trace is read by the osi3 reader until the first corrupt
+ * record, whose offset is then derived from the encoded sizes of the
+ * messages read so far.  The MCAP reader continues behind corrupt records or
+ * chunks by itself, so it is just read again.  At most
+ * kMaxConsecutiveCorruptRecords records are skipped in a row before giving
+ * up.
+ */
+
+namespace
+{
+constexpr int kMaxConsecutiveCorruptRecords = 16;
+}  // namespace
+
+std::optional<osi3::ReadResult> COSMPTraceFilePlayer::ReadFrame(bool* held)
+{
+    auto frame = ReadRecord();
+    for (int skipped = 0; !frame && FmiOnCorruptRecord() != kOnCorruptRecordAbort && skipped < kMaxConsecutiveCorruptRecords; skipped++)
+    {
+        SetFmiSkippedRecords(FmiSkippedRecords() + 1);
+        std::cerr << "Skipping corrupt record at offset " << consumed_offset_ << " of " << trace_file_path_.string() << std::endl;
+        if (!ResyncTrace() || !trace_file_reader_->HasNext())
+        {
+            break;
+        }
+        if (held != nullptr && FmiOnCorruptRecord() == kOnCorruptRecordHold && FmiValid())
+        {
+            *held = true;
+            break;
+        }
+        frame = ReadRecord();
+    }
+    return frame;
+}
+
+void COSMPTraceFilePlayer::UseRecordReader()
+{
+    if (trace_file_path_.extension() != ".osi" || trace_record_reader_ != nullptr)
+    {
+        return;
+    }
+    const osi3::ReaderTopLevelMessage message_type =
+        last_message_type_ != osi3::ReaderTopLevelMessage::kUnknown ? last_message_type_ : TraceFileMessageType(trace_file_path_);
+    auto record_reader = std::make_unique<TraceRecordReader>(message_type, consumed_offset_);
+    if (!record_reader->Open(trace_file_path_))
+    {
+        return;
+    }
+    trace_file_reader_->Close();
+    trace_record_reader_ = record_reader.get();
+    trace_file_reader_ = std::move(record_reader);
+}
+
+bool COSMPTraceFilePlayer::ResyncTrace()
+{
+    if (trace_file_path_.extension() != ".osi")
+    {
+        return true;
+    }
+    UseRecordReader();
+    if (trace_record_reader_ == nullptr)
+    {
+        return false;
+    }
+    if (!trace_record_reader_->Resync())
+    {
+        return false;
+    }
+    consumed_offset_ = trace_record_reader_->Offset();
+    NormalLog("OSI", "Resynchronized to record at offset %llu", static_cast<unsigned long long>(consumed_offset_));
+    return true;
+}
+
+void COSMPTraceFilePlayer::ResetTraceReader()
+{
+    if (trace_file_reader_ != nullptr)
+    {
+        trace_file_reader_->Close();
+        trace_file_reader_.reset();
+    }
+    trace_file_path_.clear();
+    trace_record_reader_ = nullptr;
+    publish_frame_ = nullptr;
+    consumed_offset_ = 0;
+    fastest_read_ns_per_byte_ = 0.0;
+    last_message_type_ = osi3::ReaderTopLevelMessage::kUnknown;
+    hashed_frames_ = 0;
+}
+
+/*
+ * Static Content Cache
+ *
+ * Lanes, lane boundaries, signs, road markings and stationary objects are
+ * usually repeated unchanged in every frame.  If cache_static_content is set,
+ * these fields are swapped out of the GroundTruth before serialization and
+ * their cached encoding is spliced into the output buffer instead.  Whether
+ * the cache is still valid is checked for every frame from its raw record:
+ * the encoded bytes of the static fields are hashed while the top-level
+ * fields are skipped over, and the cache is only used if this digest equals
+ * the one of the frame it was built from.  Equal static bytes parse to equal
+ * static content, whose encoding is the cached one.  The raw record is only
+ * available from the record reader, which reads .osi traces whenever the
+ * cache is enabled; other frames are always serialized completely.
+ * Traffic lights are not cached, as their state changes during playback.
+ */
+
+namespace
+{
+using google::protobuf::internal::WireFormatLite;
+
+void SwapStaticContent(osi3::GroundTruth& first, osi3::GroundTruth& second)
+{
+    first.mutable_stationary_object()->Swap(second.mutable_stationary_object());
+    first.mutable_traffic_sign()->Swap(second.mutable_traffic_sign());
+    first.mutable_road_marking()->Swap(second.mutable_road_marking());
+    first.mutable_lane_boundary()->Swap(second.mutable_lane_boundary());
+    first.mutable_lane()->Swap(second.mutable_lane());
+    first.mutable_reference_line()->Swap(second.mutable_reference_line());
+    first.mutable_logical_lane_boundary()->Swap(second.mutable_logical_lane_boundary());
+    first.mutable_logical_lane()->Swap(second.mutable_logical_lane());
+}
+
+bool IsStaticContentField(int field_number)
+{
+    switch (field_number)
+    {
+        case osi3::GroundTruth::kStationaryObjectFieldNumber:
+        case osi3::GroundTruth::kTrafficSignFieldNumber:
+        case osi3::GroundTruth::kRoadMarkingFieldNumber:
+        case osi3::GroundTruth::kLaneBoundaryFieldNumber:
+        case osi3::GroundTruth::kLaneFieldNumber:
+        case osi3::GroundTruth::kReferenceLineFieldNumber:
+        case osi3::GroundTruth::kLogicalLaneBoundaryFieldNumber:
+        case osi3::GroundTruth::kLogicalLaneFieldNumber:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* Collects the byte ranges of the static fields of an encoded GroundTruth,
+ * merging adjacent fields into one range */
+bool ScanStaticContent(google::protobuf::io::CodedInputStream& input, vector<std::pair<int, int>>& ranges)
+{
+    while (true)
+    {
+        const int start = input.CurrentPosition();
+        const uint32_t tag = input.ReadTag();
+        if (tag == 0)
+        {
+            return input.ConsumedEntireMessage();
+        }
+        if (!WireFormatLite::SkipField(&input, tag))
+        {
+            return false;
+        }
+        if (!IsStaticContentField(WireFormatLite::GetTagFieldNumber(tag)))
+        {
+            continue;
+        }
+        if (!ranges.empty() && ranges.back().second == start)
+        {
+            ranges.back().second = input.CurrentPosition();
+        }
+        else
+        {
+            ranges.emplace_back(start, input.CurrentPosition());
+        }
+    }
+}
+
+bool ScanSensorViewStaticContent(google::protobuf::io::CodedInputStream& input, vector<std::pair<int, int>>& ranges)
+{
+    while (true)
+    {
+        const uint32_t tag = input.ReadTag();
+        if (tag == 0)
+        {
+            return input.ConsumedEntireMessage();
+        }
+        if (WireFormatLite::GetTagFieldNumber(tag) != osi3::SensorView::kGlobalGroundTruthFieldNumber ||
+            WireFormatLite::GetTagWireType(tag) != WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+        {
+            if (!WireFormatLite::SkipField(&input, tag))
+            {
+                return false;
+            }
+            continue;
+        }
+        uint32_t length = 0;
+        if (!input.ReadVarint32(&length))
+        {
+            return false;
+        }
+        const auto limit = input.PushLimit(static_cast<int>(length));
+        if (!ScanStaticContent(input, ranges))
+        {
+            return false;
+        }
+        input.PopLimit(limit);
+    }
+}
+
+void AppendVarint(string* buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer->push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer->push_back(static_cast<char>(value));
+}
+
+void AppendLengthDelimitedTag(string* buffer, int field_number, size_t length)
+{
+    AppendVarint(buffer, (static_cast<uint64_t>(field_number) << 3) | 2);
+    AppendVarint(buffer, length);
+}
+}  // namespace
+
+uint64_t COSMPTraceFilePlayer::StaticContentDigest(osi3::ReaderTopLevelMessage message_type)
+{
+    if (trace_record_reader_ == nullptr ||
+        (message_type != osi3::ReaderTopLevelMessage::kGroundTruth && message_type != osi3::ReaderTopLevelMessage::kSensorView))
+    {
+        return kNoStaticContentDigest;
+    }
+
+    const string& record = trace_record_reader_->Record();
+    google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(record.data()), static_cast<int>(record.size()));
+    static_content_ranges_.clear();
+    const bool scanned = message_type == osi3::ReaderTopLevelMessage::kGroundTruth ? ScanStaticContent(input, static_content_ranges_)
+                                                                                   : ScanSensorViewStaticContent(input, static_content_ranges_);
+    if (!scanned)
+    {
+        return kNoStaticContentDigest;
+    }
+
+    static_content_range_hashes_.clear();
+    for (const auto& range : static_content_ranges_)
+    {
+        static_content_range_hashes_.push_back(FrameHash(record.data() + range.first, static_cast<size_t>(range.second - range.first)));
+    }
+    const uint64_t digest = FrameHash(static_content_range_hashes_.data(), static_content_range_hashes_.size() * sizeof(uint64_t));
+    return digest != kNoStaticContentDigest ? digest : digest + 1;
+}
+
+const string& COSMPTraceFilePlayer::CachedStaticContent()
+{
+    if (frame_static_digest_ != static_content_digest_)
+    {
+        static_content_.SerializeToString(&static_content_bytes_);
+        static_content_digest_ = frame_static_digest_;
+    }
+    return static_content_bytes_;
+}
+
+void COSMPTraceFilePlayer::AppendGroundTruth(osi3::GroundTruth& ground_truth, string* buffer, int field_number)
+{
+    /* Concatenated protobuf encodings parse as a merge, so prepending the
+     * static frame of a delta-compressed trace and the cached static content
+     * rebuilds the full GroundTruth without serializing them again. */
+    static const string no_static_content;
+    const bool cache_static_content = CacheStaticContent() && frame_static_digest_ != kNoStaticContentDigest;
+    if (cache_static_content)
+    {
+        SwapStaticContent(ground_truth, static_content_);
+    }
+    const string& static_bytes = cache_static_content ? CachedStaticContent() : no_static_content;
+
+    const string& static_prefix = shared_trace_state_->static_prefix;
+    const size_t dynamic_size = ground_truth.ByteSizeLong();
+    if (field_number != 0)
+    {
+        AppendLengthDelimitedTag(buffer, field_number, static_prefix.size() + static_bytes.size() + dynamic_size);
+    }
+    buffer->append(static_prefix);
+    buffer->append(static_bytes);
+    const size_t offset = buffer->size();
+    buffer->resize(offset + dynamic_size);
+    ground_truth.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(&(*buffer)[offset]));
+
+    if (cache_static_content)
+    {
+        SwapStaticContent(ground_truth, static_content_);
+    }
+}
+
+void COSMPTraceFilePlayer::ResetStaticContentCache()
+{
+    static_content_.Clear();
+    static_content_bytes_.clear();
+    static_content_digest_ = kNoStaticContentDigest;
+    frame_static_digest_ = kNoStaticContentDigest;
+    read_static_digest_ = kNoStaticContentDigest;
+    previous_static_digest_ = kNoStaticContentDigest;
+    next_static_digest_ = kNoStaticContentDigest;
+}
+
+/*
+ * Interpolated Playback
+ *
+ * If the master steps finer than the trace was recorded, the frames
+ * bracketing the current trace time are kept and the moving objects are
+ * interpolated between them.  The trace time starts at the timestamp of the
+ * first frame and advances with the communication points.  Message types
+ * without GroundTruth are held until the next frame is due.  In all cases
+ * the timestamp is rewritten to the current trace time.
+ */
+
+namespace
+{
+int64_t TimestampNanos(const osi3::Timestamp& timestamp)
+{
+    return timestamp.seconds() * 1000000000LL + timestamp.nanos();
+}
+
+void SetTimestampNanos(osi3::Timestamp* timestamp, int64_t nanos)
+{
+    timestamp->set_seconds(nanos / 1000000000LL);
+    timestamp->set_nanos(static_cast<uint32_t>(nanos % 1000000000LL));
+}
+
+osi3::Timestamp* FrameTimestamp(osi3::ReadResult& frame)
+{
+    switch (frame.message_type)
+    {
+        case osi3::ReaderTopLevelMessage::kSensorData:
+            return static_cast<osi3::SensorData*>(frame.message.get())->mutable_timestamp();
+        case osi3::ReaderTopLevelMessage::kSensorView:
+            return static_cast<osi3::SensorView*>(frame.message.get())->mutable_timestamp();
+        case osi3::ReaderTopLevelMessage::kGroundTruth:
+            return static_cast<osi3::GroundTruth*>(frame.message.get())->mutable_timestamp();
+        case osi3::ReaderTopLevelMessage::kTrafficCommand:
+            return static_cast<osi3::TrafficCommand*>(frame.message.get())->mutable_timestamp();
+        case osi3::ReaderTopLevelMessage::kTrafficUpdate:
+            return static_cast<osi3::TrafficUpdate*>(frame.message.get())->mutable_timestamp();
+        case osi3::ReaderTopLevelMessage::kHostVehicleData:
+            return static_cast<osi3::HostVehicleData*>(frame.message.get())->mutable_timestamp();
+        case osi3::ReaderTopLevelMessage::kStreamingUpdate:
+            return static_cast<osi3::StreamingUpdate*>(frame.message.get())->mutable_timestamp();
+        default:
+            return nullptr;
+    }
+}
+
+osi3::GroundTruth* FrameGroundTruth(osi3::ReadResult& frame)
+{
+    switch (frame.message_type)
+    {
+        case osi3::ReaderTopLevelMessage::kSensorView: {
+            auto* const sensor_view = static_cast<osi3::SensorView*>(frame.message.get());
+            return sensor_view->has_global_ground_truth() ? sensor_view->mutable_global_ground_truth() : nullptr;
+        }
+        case osi3::ReaderTopLevelMessage::kGroundTruth:
+            return static_cast<osi3::GroundTruth*>(frame.message.get());
+        default:
+            return nullptr;
+    }
 }
 
-void COSMPTraceFilePlayer::ResetFmiGroundTruthOut()
+int64_t FrameTimeNanos(osi3::ReadResult& frame)
 {
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX] = 0;
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX] = 0;
-    integer_vars_[FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX] = 0;
+    const osi3::Timestamp* const timestamp = FrameTimestamp(frame);
+    return timestamp != nullptr ? TimestampNanos(*timestamp) : 0;
+}
+}  // namespace
+
+fmi2Status COSMPTraceFilePlayer::InterpolateFrame(fmi2Real current_communication_point, osi3::ReadResult*& frame)
+{
+    const int64_t communication_point = std::llround(current_communication_point * 1e9);
+    bool frames_changed = false;
+    if (!previous_frame_)
+    {
+        if (!trace_file_reader_->HasNext())
+        {
+            std::cerr << "End of trace file reached (experiment stopTime longer than tracefile)" << std::endl;
+            return fmi2Discard;
+        }
+        previous_frame_ = ReadFrame();
+        if (!previous_frame_)
+        {
+            std::cerr << "Error reading message." << std::endl;
+            return fmi2Fatal;
+        }
+        previous_frame_time_ = FrameTimeNanos(*previous_frame_);
+        previous_static_digest_ = read_static_digest_;
+        trace_time_offset_ = previous_frame_time_ - communication_point;
+        frames_changed = true;
+    }
+
+    const int64_t trace_time = communication_point + trace_time_offset_;
+    while (true)
+    {
+        if (!next_frame_ && trace_file_reader_->HasNext())
+        {
+            next_frame_ = ReadFrame();
+            if (!next_frame_ && FmiOnCorruptRecord() != kOnCorruptRecordAbort && !trace_file_reader_->HasNext())
+            {
+                break;
+            }
+            if (!next_frame_)
+            {
+                std::cerr << "Error reading message." << std::endl;
+                return fmi2Fatal;
+            }
+            next_frame_time_ = FrameTimeNanos(*next_frame_);
+            next_static_digest_ = read_static_digest_;
+            frames_changed = true;
+        }
+        if (!next_frame_ || next_frame_time_ > trace_time)
+        {
+            break;
+        }
+        previous_frame_ = std::move(next_frame_);
+        previous_frame_time_ = next_frame_time_;
+        previous_static_digest_ = next_static_digest_;
+        next_frame_.reset();
+        frames_changed = true;
+    }
+
+    if (!next_frame_ && trace_time > previous_frame_time_)
+    {
+        std::cerr << "End of trace file reached (experiment stopTime longer than tracefile)" << std::endl;
+        return fmi2Discard;
+    }
+
+    osi3::GroundTruth* const ground_truth = FrameGroundTruth(*previous_frame_);
+    if (ground_truth != nullptr)
+    {
+        if (frames_changed)
+        {
+            frame_interpolator_.Prepare(*ground_truth, next_frame_ ? FrameGroundTruth(*next_frame_) : nullptr);
+        }
+        const double alpha = next_frame_ && next_frame_time_ > previous_frame_time_
+                                 ? static_cast<double>(trace_time - previous_frame_time_) / static_cast<double>(next_frame_time_ - previous_frame_time_)
+                                 : 0.0;
+        frame_interpolator_.Apply(*ground_truth, alpha);
+        SetTimestampNanos(ground_truth->mutable_timestamp(), trace_time);
+    }
+    osi3::Timestamp* const timestamp = FrameTimestamp(*previous_frame_);
+    if (timestamp != nullptr)
+    {
+        SetTimestampNanos(timestamp, trace_time);
+    }
+
+    frame = &*previous_frame_;
+    frame_static_digest_ = previous_static_digest_;
+    return fmi2OK;
+}
+
+void COSMPTraceFilePlayer::ResetInterpolation()
+{
+    previous_frame_.reset();
+    next_frame_.reset();
+    previous_frame_time_ = 0;
+    next_frame_time_ = 0;
+    trace_time_offset_ = 0;
+}
+
+/*
+ * Memory Budget
+ *
+ * The memory of all buffers owned by the player (output buffers, static
+ * prefix, static content cache, interpolation arrays and recording queue) is
+ * accounted after every step.  An output buffer is shrunk once it is more
+ * than twice as large as the largest frame of the last kShrinkWindow to
+ * kShrinkWindow * 2 steps, so an outlier frame does not pin its memory for
+ * the rest of the run.  If max_memory_mb is exceeded, the static content
+ * cache is given up first; if the remaining buffers still exceed it, the
+ * step fails.  Decoded messages and buffers internal to the trace reader
+ * are not accounted.
+ */
+
+namespace
+{
+constexpr int kShrinkWindow = 64;
+constexpr size_t kMinShrinkCapacity = 64 * 1024;
+constexpr size_t kBytesPerMegabyte = 1024 * 1024;
+}  // namespace
+
+size_t COSMPTraceFilePlayer::MemoryBudget()
+{
+    return static_cast<size_t>(std::max(FmiMaxMemoryMb(), 0)) * kBytesPerMegabyte;
+}
+
+size_t COSMPTraceFilePlayer::MemoryUsage()
+{
+    return current_buffer_->capacity() + last_buffer_->capacity() + static_content_bytes_.capacity() +
+           static_content_ranges_.capacity() * sizeof(std::pair<int, int>) + static_content_range_hashes_.capacity() * sizeof(uint64_t) +
+           recorded_frame_hashes_.capacity() * sizeof(uint64_t) + frame_interpolator_.MemoryUsage() +
+           trace_recorder_.MemoryUsage();
+}
+
+void COSMPTraceFilePlayer::ShrinkFrameBuffer(size_t frame_size)
+{
+    frame_size_peaks_[0] = std::max(frame_size_peaks_[0], frame_size);
+    if (++frame_size_window_steps_ == kShrinkWindow)
+    {
+        frame_size_peaks_[1] = frame_size_peaks_[0];
+        frame_size_peaks_[0] = 0;
+        frame_size_window_steps_ = 0;
+    }
+
+    /* Only the buffer written next is shrunk, the published one stays valid */
+    const size_t recent_peak = std::max(frame_size_peaks_[0], frame_size_peaks_[1]);
+    if (current_buffer_->capacity() > kMinShrinkCapacity && current_buffer_->capacity() > 2 * recent_peak)
+    {
+        string().swap(*current_buffer_);
+        current_buffer_->reserve(recent_peak);
+    }
+}
+
+bool COSMPTraceFilePlayer::UpdateMemoryUsage()
+{
+    ShrinkFrameBuffer(last_buffer_->size());
+
+    const size_t budget = MemoryBudget();
+    size_t usage = MemoryUsage();
+    if (budget != 0 && usage > budget && CacheStaticContent())
+    {
+        NormalLog("OSMP", "Memory usage of %zu KiB exceeds max_memory_mb, disabling static content cache", usage >> 10);
+        static_content_over_budget_ = true;
+        ResetStaticContentCache();
+        string().swap(static_content_bytes_);
+        vector<std::pair<int, int>>().swap(static_content_ranges_);
+        vector<uint64_t>().swap(static_content_range_hashes_);
+        usage = MemoryUsage();
+    }
+
+    SetFmiMemoryKib(static_cast<fmi2Integer>(usage >> 10));
+    SetFmiPeakMemoryKib(std::max(FmiPeakMemoryKib(), static_cast<fmi2Integer>(usage >> 10)));
+    if (budget != 0 && usage > budget)
+    {
+        std::cerr << "Memory usage of " << (usage >> 10) << " KiB exceeds max_memory_mb of " << FmiMaxMemoryMb() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Worker Thread Placement
+ */
+
+void COSMPTraceFilePlayer::BindFrameBuffer(const string& buffer)
+{
+    /* Rebind only after the buffer has been reallocated */
+    for (const auto& bound_frame_buffer : bound_frame_buffers_)
+    {
+        if (bound_frame_buffer.first == buffer.data() && bound_frame_buffer.second == buffer.capacity())
+        {
+            return;
+        }
+    }
+    worker_placement_.BindMemory(buffer.data(), buffer.capacity());
+    bound_frame_buffers_[next_bound_frame_buffer_] = {buffer.data(), buffer.capacity()};
+    next_bound_frame_buffer_ = (next_bound_frame_buffer_ + 1) % 2;
 }
 
 /*
@@ -182,6 +1055,7 @@ fmi2Status COSMPTraceFilePlayer::DoInit()
     {
         integer_var = 0;
     }
+    integer_vars_[FMI_INTEGER_WORKER_NUMA_NODE_IDX] = -1;
 
     /* Reals */
     for (double& real_var : real_vars_)
@@ -216,88 +1090,432 @@ fmi2Status COSMPTraceFilePlayer::DoExitInitializationMode()
 {
     DEBUGBREAK();
 
-    const std::filesystem::path folder_path = FmiTracePath();
-    std::string trace_file_name = FmiTraceName();
-    if (trace_file_name.empty())
+    if (FmiTracePath().empty())
     {
-        for (const auto& entry : std::filesystem::directory_iterator(folder_path))
+        std::cerr << "Parameter trace_path is not set" << std::endl;
+        return fmi2Error;
+    }
+    if (!pending_trace_.valid() && trace_file_reader_ == nullptr)
+    {
+        StartTraceOpen();
+    }
+
+    ResetStaticContentCache();
+    static_content_over_budget_ = false;
+    ResetSynthesizedSensorView();
+    ResetInterpolation();
+
+    worker_placement_ = ThreadPlacement::FromParameters(FmiWorkerCpus(), FmiWorkerNumaNode());
+    SetFmiWorkerPlacement(worker_placement_.Describe());
+    NormalLog("OSMP", "Worker placement: %s", worker_placement_.Describe().c_str());
+
+    const std::filesystem::path record_path = FmiRecordPath();
+    if (!record_path.empty())
+    {
+        if (record_path.extension() != ".osi")
         {
-            if (entry.path().extension() == ".osi")
-            {
-                trace_file_name = entry.path().filename().string();
-                break;
-            }
+            std::cerr << "Recording is only supported to .osi trace files: " << record_path.string() << std::endl;
+            return fmi2Error;
+        }
+        if (!trace_recorder_.Open(record_path, worker_placement_, MemoryBudget() / 4))
+        {
+            std::cerr << "Could not open record file " << record_path.string() << std::endl;
+            return fmi2Error;
         }
     }
+    return fmi2OK;
+}
 
-    if (trace_file_name.empty())
+/*
+ * Frame Hashes
+ *
+ * With hash_frames set, the XXH64 digest of every published buffer is
+ * provided as frame_hash_lo/frame_hash_hi, so that replays can be compared
+ * bit by bit across runs and machines.  If the trace has a frame hash list
+ * beside it, the n-th published buffer is compared against its n-th entry
+ * and mismatches are counted; steps holding the last frame are not
+ * compared.  When recording, the digests of the recorded buffers are written
+ * beside the record file on termination, which yields the hash list for
+ * replaying the recording.
+ */
+
+void COSMPTraceFilePlayer::HashFrame(const string& buffer, bool published)
+{
+    const uint64_t hash = FrameHash(buffer.data(), buffer.size());
+    SetFmiFrameHashLo(static_cast<fmi2Integer>(hash & 0xFFFFFFFFULL));
+    SetFmiFrameHashHi(static_cast<fmi2Integer>(hash >> 32));
+
+    /* A held frame is no new frame of the trace and is not verified again */
+    const vector<uint64_t>& expected_hashes = shared_trace_state_->frame_hashes;
+    if (published)
     {
-        throw std::runtime_error("No trace file found in " + folder_path.string());
+        const size_t frame = hashed_frames_++;
+        if (frame < expected_hashes.size() && expected_hashes[frame] != hash)
+        {
+            SetFmiHashMismatches(FmiHashMismatches() + 1);
+            NormalLog("OSI", "Hash %016" PRIx64 " of frame %zu does not match expected %016" PRIx64, hash, frame, expected_hashes[frame]);
+        }
+    }
+    if (trace_recorder_.IsOpen())
+    {
+        recorded_frame_hashes_.push_back(hash);
     }
+}
 
-    const std::filesystem::path trace_path = folder_path / trace_file_name;
+/*
+ * Message Type Specialization
+ *
+ * The playback path is instantiated per top-level message type.  The type is
+ * resolved once from the first frame of the trace, as the trace is opened
+ * asynchronously; every step then runs the specialized path without
+ * switching on the type or casting with RTTI.  Supporting another top-level
+ * message type takes a TopLevelMessage specialization, naming its OSMP output
+ * variables, and a case in ResolvePublishFrame().
+ *
+ * StreamingUpdate messages are small deltas at a high rate, which must not
+ * be dropped or repeated.  After the first update, each step therefore
+ * publishes all updates up to the current trace time as one message, by
+ * concatenating their encodings; they bypass the static content cache,
+ * ego transformation and interpolation.  A step without due updates
+ * publishes, records and hashes nothing and reports valid as false.
+ */
+
+namespace
+{
+template <typename T>
+struct TopLevelMessage;
+
+template <osi3::ReaderTopLevelMessage Type, int BaseLoIdx, int BaseHiIdx, int SizeIdx>
+struct OsmpOutput
+{
+    static constexpr osi3::ReaderTopLevelMessage kType = Type;
+    static constexpr int kBaseLoIdx = BaseLoIdx;
+    static constexpr int kBaseHiIdx = BaseHiIdx;
+    static constexpr int kSizeIdx = SizeIdx;
+};
+
+using SensorViewOutput =
+    OsmpOutput<osi3::ReaderTopLevelMessage::kUnknown, FMI_INTEGER_SENSORVIEW_OUT_BASELO_IDX, FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX, FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX>;
+
+/* SensorData, SensorView and GroundTruth share the historical OSMPSensorViewOut */
+template <>
+struct TopLevelMessage<osi3::SensorData> : SensorViewOutput
+{
+    static constexpr osi3::ReaderTopLevelMessage kType = osi3::ReaderTopLevelMessage::kSensorData;
+};
+
+template <>
+struct TopLevelMessage<osi3::SensorView> : SensorViewOutput
+{
+    static constexpr osi3::ReaderTopLevelMessage kType = osi3::ReaderTopLevelMessage::kSensorView;
+};
+
+template <>
+struct TopLevelMessage<osi3::GroundTruth> : SensorViewOutput
+{
+    static constexpr osi3::ReaderTopLevelMessage kType = osi3::ReaderTopLevelMessage::kGroundTruth;
+};
+
+template <>
+struct TopLevelMessage<osi3::TrafficCommand> : OsmpOutput<osi3::ReaderTopLevelMessage::kTrafficCommand,
+                                                          FMI_INTEGER_TRAFFICCOMMAND_OUT_BASELO_IDX,
+                                                          FMI_INTEGER_TRAFFICCOMMAND_OUT_BASEHI_IDX,
+                                                          FMI_INTEGER_TRAFFICCOMMAND_OUT_SIZE_IDX>
+{
+};
+
+template <>
+struct TopLevelMessage<osi3::TrafficUpdate> : OsmpOutput<osi3::ReaderTopLevelMessage::kTrafficUpdate,
+                                                         FMI_INTEGER_TRAFFICUPDATE_OUT_BASELO_IDX,
+                                                         FMI_INTEGER_TRAFFICUPDATE_OUT_BASEHI_IDX,
+                                                         FMI_INTEGER_TRAFFICUPDATE_OUT_SIZE_IDX>
+{
+};
+
+template <>
+struct TopLevelMessage<osi3::HostVehicleData> : OsmpOutput<osi3::ReaderTopLevelMessage::kHostVehicleData,
+                                                           FMI_INTEGER_HOSTVEHICLEDATA_OUT_BASELO_IDX,
+                                                           FMI_INTEGER_HOSTVEHICLEDATA_OUT_BASEHI_IDX,
+                                                           FMI_INTEGER_HOSTVEHICLEDATA_OUT_SIZE_IDX>
+{
+};
 
-    trace_file_reader_ = osi3::TraceFileReaderFactory::createReader(trace_path);
+template <>
+struct TopLevelMessage<osi3::StreamingUpdate> : OsmpOutput<osi3::ReaderTopLevelMessage::kStreamingUpdate,
+                                                           FMI_INTEGER_STREAMINGUPDATE_OUT_BASELO_IDX,
+                                                           FMI_INTEGER_STREAMINGUPDATE_OUT_BASEHI_IDX,
+                                                           FMI_INTEGER_STREAMINGUPDATE_OUT_SIZE_IDX>
+{
+};
+}  // namespace
 
-    if (!trace_file_reader_->Open(trace_path))
+COSMPTraceFilePlayer::PublishFunction COSMPTraceFilePlayer::ResolvePublishFrame(osi3::ReaderTopLevelMessage message_type)
+{
+    switch (message_type)
     {
+        case osi3::ReaderTopLevelMessage::kSensorData:
+            return &COSMPTraceFilePlayer::PublishFrame<osi3::SensorData>;
+        case osi3::ReaderTopLevelMessage::kSensorView:
+            return &COSMPTraceFilePlayer::PublishFrame<osi3::SensorView>;
+        case osi3::ReaderTopLevelMessage::kGroundTruth:
+            return &COSMPTraceFilePlayer::PublishFrame<osi3::GroundTruth>;
+        case osi3::ReaderTopLevelMessage::kTrafficCommand:
+            return &COSMPTraceFilePlayer::PublishFrame<osi3::TrafficCommand>;
+        case osi3::ReaderTopLevelMessage::kTrafficUpdate:
+            return &COSMPTraceFilePlayer::PublishFrame<osi3::TrafficUpdate>;
+        case osi3::ReaderTopLevelMessage::kHostVehicleData:
+            return &COSMPTraceFilePlayer::PublishFrame<osi3::HostVehicleData>;
+        case osi3::ReaderTopLevelMessage::kStreamingUpdate:
+            return &COSMPTraceFilePlayer::PublishFrame<osi3::StreamingUpdate>;
+        default:
+            return nullptr;
+    }
+}
 
+template <typename T>
+fmi2Status COSMPTraceFilePlayer::PublishFrame(osi3::ReadResult& frame)
+{
+    if (frame.message_type != TopLevelMessage<T>::kType)
+    {
+        std::cerr << "Message type changed during playback" << std::endl;
         return fmi2Fatal;
     }
+    auto* message = static_cast<T*>(frame.message.get());
+    if (FmiEgoCoordinates())
+    {
+        /* Interpolated playback publishes a frame on several steps, so it
+         * has to stay in world coordinates and a copy is transformed */
+        if (FmiInterpolate())
+        {
+            if (ego_frame_ == nullptr || ego_frame_->GetDescriptor() != message->GetDescriptor())
+            {
+                ego_frame_.reset(message->New());
+            }
+            ego_frame_->CopyFrom(*message);
+            message = static_cast<T*>(ego_frame_.get());
+        }
+        if (!TransformToEgo(*message))
+        {
+            std::cerr << "Host vehicle not found, cannot transform " << message->GetTypeName() << " into ego coordinates" << std::endl;
+            return fmi2Error;
+        }
+    }
+    SerializeToBuffer(*message);
+    PublishBuffer(TopLevelMessage<T>::kBaseLoIdx, TopLevelMessage<T>::kBaseHiIdx, TopLevelMessage<T>::kSizeIdx);
     return fmi2OK;
 }
 
-fmi2Status COSMPTraceFilePlayer::DoCalc(fmi2Real current_communication_point, fmi2Real communication_step_size, fmi2Boolean no_set_fmu_state_prior_to_current_point)
+template <typename T>
+bool COSMPTraceFilePlayer::TransformToEgo(T& /*data*/)
 {
+    return true;
+}
 
-    if (!trace_file_reader_->HasNext())
+bool COSMPTraceFilePlayer::TransformToEgo(osi3::SensorView& data)
+{
+    if (!data.has_global_ground_truth())
+    {
+        return true;
+    }
+    const auto& host_vehicle_id = data.has_host_vehicle_id() ? data.host_vehicle_id() : data.global_ground_truth().host_vehicle_id();
+    return ego_transform_.Apply(*data.mutable_global_ground_truth(), host_vehicle_id.value());
+}
+
+bool COSMPTraceFilePlayer::TransformToEgo(osi3::GroundTruth& data)
+{
+    return ego_transform_.Apply(data, data.host_vehicle_id().value());
+}
+
+fmi2Status COSMPTraceFilePlayer::PublishStreamingUpdates(fmi2Real current_communication_point, bool& updated)
+{
+    const int64_t trace_time = std::llround(current_communication_point * 1e9) + trace_time_offset_;
+    current_buffer_->clear();
+    while (true)
+    {
+        if (!next_frame_)
+        {
+            if (!trace_file_reader_->HasNext())
+            {
+                break;
+            }
+            next_frame_ = ReadFrame();
+            if (!next_frame_ && FmiOnCorruptRecord() != kOnCorruptRecordAbort && !trace_file_reader_->HasNext())
+            {
+                break;
+            }
+            if (!next_frame_)
+            {
+                std::cerr << "Error reading message." << std::endl;
+                return fmi2Fatal;
+            }
+            if (next_frame_->message_type != osi3::ReaderTopLevelMessage::kStreamingUpdate)
+            {
+                std::cerr << "Message type changed during playback" << std::endl;
+                return fmi2Fatal;
+            }
+            next_frame_time_ = FrameTimeNanos(*next_frame_);
+        }
+        if (next_frame_time_ > trace_time)
+        {
+            break;
+        }
+        /* Concatenated encodings parse as one message, whose repeated fields
+         * hold the entries of all due updates in trace order; entries for the
+         * same object id are not merged */
+        next_frame_->message->AppendToString(current_buffer_);
+        next_frame_.reset();
+    }
+
+    if (current_buffer_->empty() && !next_frame_ && !trace_file_reader_->HasNext())
     {
         std::cerr << "End of trace file reached (experiment stopTime longer than tracefile)" << std::endl;
         return fmi2Discard;
     }
 
-    const auto reading_result = trace_file_reader_->ReadMessage();
-    if (!reading_result)
+    /* Without due updates, the output keeps the last message and is marked invalid for the step */
+    updated = !current_buffer_->empty();
+    if (!updated)
+    {
+        return fmi2OK;
+    }
+    PublishBuffer(FMI_INTEGER_STREAMINGUPDATE_OUT_BASELO_IDX, FMI_INTEGER_STREAMINGUPDATE_OUT_BASEHI_IDX, FMI_INTEGER_STREAMINGUPDATE_OUT_SIZE_IDX);
+    return fmi2OK;
+}
+
+fmi2Status COSMPTraceFilePlayer::DoCalc(fmi2Real current_communication_point, fmi2Real communication_step_size, fmi2Boolean no_set_fmu_state_prior_to_current_point)
+{
+    if (!AwaitTraceOpen())
     {
-        std::cerr << "Error reading message." << std::endl;
         return fmi2Fatal;
     }
 
-    switch (reading_result->message_type)
+    const auto step_start = std::chrono::steady_clock::now();
+    const string* const step_buffer = current_buffer_;
+    const size_t step_buffer_capacity = step_buffer->capacity();
+    bool published = true;
+    bool updated = true;
+    if (last_message_type_ == osi3::ReaderTopLevelMessage::kStreamingUpdate && publish_frame_ != nullptr)
     {
-        case osi3::ReaderTopLevelMessage::kSensorData: {
-            auto* const sensor_data = dynamic_cast<osi3::SensorData*>(reading_result->message.get());
-            SetFmiSensorDataOut(*sensor_data);
-            break;
+        const fmi2Status status = PublishStreamingUpdates(current_communication_point, updated);
+        if (status != fmi2OK)
+        {
+            return status;
         }
-        case osi3::ReaderTopLevelMessage::kSensorView: {
-            auto* const sensor_view = dynamic_cast<osi3::SensorView*>(reading_result->message.get());
-            SetFmiSensorViewOut(*sensor_view);
-            break;
+    }
+    else
+    {
+        std::optional<osi3::ReadResult> reading_result;
+        osi3::ReadResult* frame = nullptr;
+        if (FmiInterpolate())
+        {
+            const fmi2Status status = InterpolateFrame(current_communication_point, frame);
+            if (status != fmi2OK)
+            {
+                return status;
+            }
         }
-        case osi3::ReaderTopLevelMessage::kGroundTruth: {
-            auto* const ground_truth = dynamic_cast<osi3::GroundTruth*>(reading_result->message.get());
-            SetFmiGroundTruthOut(*ground_truth);
-            break;
+        else
+        {
+            if (!trace_file_reader_->HasNext())
+            {
+                std::cerr << "End of trace file reached (experiment stopTime longer than tracefile)" << std::endl;
+                return fmi2Discard;
+            }
+
+            bool held = false;
+            reading_result = ReadFrame(&held);
+            if (!reading_result && !held)
+            {
+                if (FmiOnCorruptRecord() != kOnCorruptRecordAbort && !trace_file_reader_->HasNext())
+                {
+                    std::cerr << "End of trace file reached while skipping corrupt records" << std::endl;
+                    return fmi2Discard;
+                }
+                std::cerr << "Error reading message." << std::endl;
+                return fmi2Fatal;
+            }
+            frame = reading_result ? &*reading_result : nullptr;
+            frame_static_digest_ = read_static_digest_;
+            if (frame != nullptr && frame->message_type == osi3::ReaderTopLevelMessage::kStreamingUpdate)
+            {
+                trace_time_offset_ = FrameTimeNanos(*frame) - std::llround(current_communication_point * 1e9);
+            }
         }
-        default: {
-            std::cerr << "Could not determine type of message or is not a SensorData, SensorView or GroundTruth" << std::endl;
-            return fmi2Fatal;
+
+        /* A held frame is still published from the last buffer */
+        published = frame != nullptr;
+        if (frame != nullptr)
+        {
+            if (publish_frame_ == nullptr)
+            {
+                publish_frame_ = ResolvePublishFrame(frame->message_type);
+                if (publish_frame_ == nullptr)
+                {
+                    std::cerr << "Could not determine type of message or is not a supported top-level message" << std::endl;
+                    return fmi2Fatal;
+                }
+            }
+            const fmi2Status status = (this->*publish_frame_)(*frame);
+            if (status != fmi2OK)
+            {
+                return status;
+            }
         }
     }
-    SetFmiValid(1);
+    if (updated && !worker_placement_.IsDefault())
+    {
+        BindFrameBuffer(*last_buffer_);
+    }
+    if (updated && trace_recorder_.IsOpen())
+    {
+        trace_recorder_.Write(*last_buffer_);
+    }
+    if (updated && FmiHashFrames())
+    {
+        HashFrame(*last_buffer_, published);
+    }
+    if (!UpdateMemoryUsage())
+    {
+        return fmi2Error;
+    }
+
+    /* Steps that had to grow or shrink the output buffer; allocations of the
+     * trace reader and of decoded messages are not counted */
+    if (step_buffer->capacity() != step_buffer_capacity)
+    {
+        SetFmiOutputBufferReallocations(FmiOutputBufferReallocations() + 1);
+    }
+    step_time_total_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - step_start).count();
+    SetFmiMeanStepTime(step_time_total_ / static_cast<double>(++step_count_));
+    SetFmiValid(updated ? 1 : 0);
     return fmi2OK;
 }
 
 fmi2Status COSMPTraceFilePlayer::DoTerm()
 {
     DEBUGBREAK();
+    if (!trace_recorder_.Close())
+    {
+        std::cerr << "Could not write record file " << FmiRecordPath() << std::endl;
+        return fmi2Error;
+    }
+    if (!recorded_frame_hashes_.empty())
+    {
+        const string hash_path = FmiRecordPath() + ".xxh64";
+        const bool written = WriteFrameHashes(hash_path, recorded_frame_hashes_);
+        recorded_frame_hashes_.clear();
+        if (!written)
+        {
+            std::cerr << "Could not write frame hash list " << hash_path << std::endl;
+            return fmi2Error;
+        }
+    }
     return fmi2OK;
 }
 
 fmi2Status COSMPTraceFilePlayer::GetBooleanStatus(fmi2StatusKind s, fmi2Boolean* value) const
 {
-    if (s == fmi2Terminated)
+    if (s == fmi2Terminated && trace_file_reader_ != nullptr)
     {
         return trace_file_reader_->HasNext() ? fmi2Discard : fmi2OK;
     }
@@ -331,6 +1549,7 @@ COSMPTraceFilePlayer::COSMPTraceFilePlayer(fmi2String theinstance_name,
 {
     current_buffer_ = new string();
     last_buffer_ = new string();
+    integer_vars_[FMI_INTEGER_WORKER_NUMA_NODE_IDX] = -1;
 
     logging_categories_.clear();
     logging_categories_.insert("FMI");
@@ -423,7 +1642,7 @@ fmi2Status COSMPTraceFilePlayer::DoStep(fmi2Real current_communication_point, fm
     return DoCalc(current_communication_point, communication_step_size, no_set_fmu_state_prior_to_current_pointfmi_2_component);
 }
 
-fmi2Status COSMPTraceFilePlayer::Terminate()  // NOLINT (returns always OK)
+fmi2Status COSMPTraceFilePlayer::Terminate()
 {
     FmiVerboseLog("fmi2Terminate()");
     return DoTerm();
@@ -432,10 +1651,18 @@ fmi2Status COSMPTraceFilePlayer::Terminate()  // NOLINT (returns always OK)
 fmi2Status COSMPTraceFilePlayer::Reset()  // NOLINT (returns always OK)
 {
     FmiVerboseLog("fmi2Reset()");
-    if (trace_file_reader_ != nullptr)
+    if (pending_trace_.valid())
     {
-        trace_file_reader_->Close();
+        pending_trace_.get();
     }
+    ResetTraceReader();
+    trace_readahead_.Close();
+    shared_trace_state_ = std::make_shared<const SharedTraceState>();
+    ResetInterpolation();
+    trace_recorder_.Close();
+    recorded_frame_hashes_.clear();
+    step_count_ = 0;
+    step_time_total_ = 0.0;
     DoFree();
     return DoInit();
 }
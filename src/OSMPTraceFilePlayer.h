@@ -42,7 +42,13 @@ using namespace std;
 
 /* Boolean Variables */
 #define FMI_BOOLEAN_VALID_IDX 0
-#define FMI_BOOLEAN_LAST_IDX FMI_BOOLEAN_VALID_IDX
+#define FMI_BOOLEAN_CACHE_STATIC_CONTENT_IDX 1
+#define FMI_BOOLEAN_EGO_COORDINATES_IDX 2
+#define FMI_BOOLEAN_SYNTHESIZE_SENSOR_VIEW_IDX 3
+#define FMI_BOOLEAN_INTERPOLATE_IDX 4
+#define FMI_BOOLEAN_HASH_FRAMES_IDX 5
+#define FMI_BOOLEAN_DROP_PLAYED_PAGES_IDX 6
+#define FMI_BOOLEAN_LAST_IDX FMI_BOOLEAN_DROP_PLAYED_PAGES_IDX
 #define FMI_BOOLEAN_VARS (FMI_BOOLEAN_LAST_IDX + 1)
 
 /* Integer Variables */
@@ -50,29 +56,80 @@ using namespace std;
 #define FMI_INTEGER_SENSORVIEW_OUT_BASEHI_IDX 1
 #define FMI_INTEGER_SENSORVIEW_OUT_SIZE_IDX 2
 #define FMI_INTEGER_COUNT_IDX 3
-#define FMI_INTEGER_LAST_IDX FMI_INTEGER_COUNT_IDX
+#define FMI_INTEGER_WORKER_NUMA_NODE_IDX 4
+#define FMI_INTEGER_READAHEAD_KIB_IDX 5
+#define FMI_INTEGER_READ_STALLS_IDX 6
+#define FMI_INTEGER_MAX_MEMORY_MB_IDX 7
+#define FMI_INTEGER_MEMORY_KIB_IDX 8
+#define FMI_INTEGER_PEAK_MEMORY_KIB_IDX 9
+#define FMI_INTEGER_ON_CORRUPT_RECORD_IDX 10
+#define FMI_INTEGER_SKIPPED_RECORDS_IDX 11
+#define FMI_INTEGER_TRAFFICCOMMAND_OUT_BASELO_IDX 12
+#define FMI_INTEGER_TRAFFICCOMMAND_OUT_BASEHI_IDX 13
+#define FMI_INTEGER_TRAFFICCOMMAND_OUT_SIZE_IDX 14
+#define FMI_INTEGER_TRAFFICUPDATE_OUT_BASELO_IDX 15
+#define FMI_INTEGER_TRAFFICUPDATE_OUT_BASEHI_IDX 16
+#define FMI_INTEGER_TRAFFICUPDATE_OUT_SIZE_IDX 17
+#define FMI_INTEGER_HOSTVEHICLEDATA_OUT_BASELO_IDX 18
+#define FMI_INTEGER_HOSTVEHICLEDATA_OUT_BASEHI_IDX 19
+#define FMI_INTEGER_HOSTVEHICLEDATA_OUT_SIZE_IDX 20
+#define FMI_INTEGER_STREAMINGUPDATE_OUT_BASELO_IDX 21
+#define FMI_INTEGER_STREAMINGUPDATE_OUT_BASEHI_IDX 22
+#define FMI_INTEGER_STREAMINGUPDATE_OUT_SIZE_IDX 23
+#define FMI_INTEGER_OUTPUT_BUFFER_REALLOCATIONS_IDX 24
+#define FMI_INTEGER_FRAME_HASH_LO_IDX 25
+#define FMI_INTEGER_FRAME_HASH_HI_IDX 26
+#define FMI_INTEGER_HASH_MISMATCHES_IDX 27
+#define FMI_INTEGER_LAST_IDX FMI_INTEGER_HASH_MISMATCHES_IDX
 #define FMI_INTEGER_VARS (FMI_INTEGER_LAST_IDX + 1)
 
 /* Real Variables */
-#define FMI_REAL_LAST_IDX 0
+#define FMI_REAL_MOUNTING_POSITION_X_IDX 0
+#define FMI_REAL_MOUNTING_POSITION_Y_IDX 1
+#define FMI_REAL_MOUNTING_POSITION_Z_IDX 2
+#define FMI_REAL_MOUNTING_POSITION_ROLL_IDX 3
+#define FMI_REAL_MOUNTING_POSITION_PITCH_IDX 4
+#define FMI_REAL_MOUNTING_POSITION_YAW_IDX 5
+#define FMI_REAL_TRACE_OPEN_TIME_IDX 6
+#define FMI_REAL_MEAN_STEP_TIME_IDX 7
+#define FMI_REAL_LAST_IDX FMI_REAL_MEAN_STEP_TIME_IDX
 #define FMI_REAL_VARS (FMI_REAL_LAST_IDX + 1)
 
 /* String Variables */
 #define FMI_STRING_TRACE_PATH_IDX 0
 #define FMI_STRING_TRACE_NAME_IDX 1
-#define FMI_STRING_LAST_IDX FMI_STRING_TRACE_NAME_IDX
+#define FMI_STRING_STATIC_TRACE_NAME_IDX 2
+#define FMI_STRING_RECORD_PATH_IDX 3
+#define FMI_STRING_WORKER_CPUS_IDX 4
+#define FMI_STRING_WORKER_PLACEMENT_IDX 5
+#define FMI_STRING_LAST_IDX FMI_STRING_WORKER_PLACEMENT_IDX
 #define FMI_STRING_VARS (FMI_STRING_LAST_IDX + 1)
 
 #include <cstdarg>
+#include <future>
+#include <memory>
+#include <optional>
 #include <set>
 #include <string>
+#include <vector>
 
 #undef min
 #undef max
+#include "EgoTransform.h"
+#include "FrameHash.h"
+#include "FrameInterpolator.h"
+#include "ThreadPlacement.h"
+#include "TraceFileAccess.h"
+#include "TraceReadahead.h"
+#include "TraceRecorder.h"
 #include "osi-utilities/tracefile/Reader.h"
 #include "osi_sensordata.pb.h"
 #include "osi_sensorview.pb.h"
 #include "osi_groundtruth.pb.h"
+#include "osi_hostvehicledata.pb.h"
+#include "osi_streamingupdate.pb.h"
+#include "osi_trafficcommand.pb.h"
+#include "osi_trafficupdate.pb.h"
 
 /* FMU Class */
 class COSMPTraceFilePlayer
@@ -119,7 +176,7 @@ class COSMPTraceFilePlayer
     static fmi2Status DoEnterInitializationMode();
     fmi2Status DoExitInitializationMode();
     fmi2Status DoCalc(fmi2Real current_communication_point, fmi2Real communication_step_size, fmi2Boolean no_set_fmu_state_prior_to_current_point);
-    static fmi2Status DoTerm();
+    fmi2Status DoTerm();
     static void DoFree();
 
     /* Private File-based Logging just for Debugging */
@@ -213,25 +270,161 @@ class COSMPTraceFilePlayer
     string* current_buffer_;
     string* last_buffer_;
     std::unique_ptr<osi3::TraceFileReader> trace_file_reader_;
+    using PublishFunction = fmi2Status (COSMPTraceFilePlayer::*)(osi3::ReadResult& frame);
+    PublishFunction publish_frame_ = nullptr;
+    std::filesystem::path trace_file_path_;
+    TraceRecordReader* trace_record_reader_ = nullptr;
+    uint64_t consumed_offset_ = 0;
+    double fastest_read_ns_per_byte_ = 0.0;
+    osi3::ReaderTopLevelMessage last_message_type_ = osi3::ReaderTopLevelMessage::kUnknown;
+    struct SharedTraceState
+    {
+        string static_prefix;
+        vector<uint64_t> frame_hashes;
+    };
+    struct OpenedTrace
+    {
+        std::unique_ptr<osi3::TraceFileReader> reader;
+        std::filesystem::path trace_path;
+        std::shared_ptr<const SharedTraceState> shared_state;
+        double open_time = 0.0;
+    };
+    std::future<OpenedTrace> pending_trace_;
+    std::shared_ptr<const SharedTraceState> shared_trace_state_ = std::make_shared<const SharedTraceState>();
+    osi3::GroundTruth static_content_;
+    string static_content_bytes_;
+    static constexpr uint64_t kNoStaticContentDigest = 0;
+    uint64_t static_content_digest_ = kNoStaticContentDigest;
+    uint64_t read_static_digest_ = kNoStaticContentDigest;
+    uint64_t frame_static_digest_ = kNoStaticContentDigest;
+    uint64_t previous_static_digest_ = kNoStaticContentDigest;
+    uint64_t next_static_digest_ = kNoStaticContentDigest;
+    vector<std::pair<int, int>> static_content_ranges_;
+    vector<uint64_t> static_content_range_hashes_;
+    bool static_content_over_budget_ = false;
+    EgoTransform ego_transform_;
+    std::unique_ptr<google::protobuf::Message> ego_frame_;
+    osi3::SensorView synthesized_sensor_view_;
+    std::optional<osi3::ReadResult> previous_frame_;
+    std::optional<osi3::ReadResult> next_frame_;
+    int64_t previous_frame_time_ = 0;
+    int64_t next_frame_time_ = 0;
+    int64_t trace_time_offset_ = 0;
+    FrameInterpolator frame_interpolator_;
+    TraceRecorder trace_recorder_;
+    TraceReadahead trace_readahead_;
+    ThreadPlacement worker_placement_;
+    std::pair<const void*, size_t> bound_frame_buffers_[2]{};
+    uint64_t step_count_ = 0;
+    double step_time_total_ = 0.0;
+    vector<uint64_t> recorded_frame_hashes_;
+    size_t hashed_frames_ = 0;
+    size_t next_bound_frame_buffer_ = 0;
+    size_t frame_size_peaks_[2]{};
+    int frame_size_window_steps_ = 0;
 
     int ReallocBuffer(char** message_buf, size_t new_size);
 
     /* Simple Accessors */
     fmi2Boolean FmiValid() { return boolean_vars_[FMI_BOOLEAN_VALID_IDX]; }
     void SetFmiValid(fmi2Boolean value) { boolean_vars_[FMI_BOOLEAN_VALID_IDX] = value; }
+    fmi2Boolean FmiCacheStaticContent() { return boolean_vars_[FMI_BOOLEAN_CACHE_STATIC_CONTENT_IDX]; }
+    fmi2Boolean FmiEgoCoordinates() { return boolean_vars_[FMI_BOOLEAN_EGO_COORDINATES_IDX]; }
+    fmi2Boolean FmiSynthesizeSensorView() { return boolean_vars_[FMI_BOOLEAN_SYNTHESIZE_SENSOR_VIEW_IDX]; }
+    fmi2Boolean FmiInterpolate() { return boolean_vars_[FMI_BOOLEAN_INTERPOLATE_IDX]; }
+    fmi2Boolean FmiHashFrames() { return boolean_vars_[FMI_BOOLEAN_HASH_FRAMES_IDX]; }
+    fmi2Boolean FmiDropPlayedPages() { return boolean_vars_[FMI_BOOLEAN_DROP_PLAYED_PAGES_IDX]; }
+    fmi2Real FmiMountingPositionX() { return real_vars_[FMI_REAL_MOUNTING_POSITION_X_IDX]; }
+    fmi2Real FmiMountingPositionY() { return real_vars_[FMI_REAL_MOUNTING_POSITION_Y_IDX]; }
+    fmi2Real FmiMountingPositionZ() { return real_vars_[FMI_REAL_MOUNTING_POSITION_Z_IDX]; }
+    fmi2Real FmiMountingPositionRoll() { return real_vars_[FMI_REAL_MOUNTING_POSITION_ROLL_IDX]; }
+    fmi2Real FmiMountingPositionPitch() { return real_vars_[FMI_REAL_MOUNTING_POSITION_PITCH_IDX]; }
+    fmi2Real FmiMountingPositionYaw() { return real_vars_[FMI_REAL_MOUNTING_POSITION_YAW_IDX]; }
+    void SetFmiTraceOpenTime(fmi2Real value) { real_vars_[FMI_REAL_TRACE_OPEN_TIME_IDX] = value; }
+    void SetFmiMeanStepTime(fmi2Real value) { real_vars_[FMI_REAL_MEAN_STEP_TIME_IDX] = value; }
     fmi2Integer FmiCount() { return integer_vars_[FMI_INTEGER_COUNT_IDX]; }
     void SetFmiCount(fmi2Integer value) { integer_vars_[FMI_INTEGER_COUNT_IDX] = value; }
+    fmi2Integer FmiWorkerNumaNode() { return integer_vars_[FMI_INTEGER_WORKER_NUMA_NODE_IDX]; }
+    void SetFmiReadaheadKib(fmi2Integer value) { integer_vars_[FMI_INTEGER_READAHEAD_KIB_IDX] = value; }
+    fmi2Integer FmiReadStalls() { return integer_vars_[FMI_INTEGER_READ_STALLS_IDX]; }
+    void SetFmiReadStalls(fmi2Integer value) { integer_vars_[FMI_INTEGER_READ_STALLS_IDX] = value; }
+    fmi2Integer FmiMaxMemoryMb() { return integer_vars_[FMI_INTEGER_MAX_MEMORY_MB_IDX]; }
+    void SetFmiMemoryKib(fmi2Integer value) { integer_vars_[FMI_INTEGER_MEMORY_KIB_IDX] = value; }
+    fmi2Integer FmiPeakMemoryKib() { return integer_vars_[FMI_INTEGER_PEAK_MEMORY_KIB_IDX]; }
+    void SetFmiPeakMemoryKib(fmi2Integer value) { integer_vars_[FMI_INTEGER_PEAK_MEMORY_KIB_IDX] = value; }
+    fmi2Integer FmiOnCorruptRecord() { return integer_vars_[FMI_INTEGER_ON_CORRUPT_RECORD_IDX]; }
+    fmi2Integer FmiSkippedRecords() { return integer_vars_[FMI_INTEGER_SKIPPED_RECORDS_IDX]; }
+    void SetFmiSkippedRecords(fmi2Integer value) { integer_vars_[FMI_INTEGER_SKIPPED_RECORDS_IDX] = value; }
+    fmi2Integer FmiOutputBufferReallocations() { return integer_vars_[FMI_INTEGER_OUTPUT_BUFFER_REALLOCATIONS_IDX]; }
+    void SetFmiOutputBufferReallocations(fmi2Integer value) { integer_vars_[FMI_INTEGER_OUTPUT_BUFFER_REALLOCATIONS_IDX] = value; }
+    void SetFmiFrameHashLo(fmi2Integer value) { integer_vars_[FMI_INTEGER_FRAME_HASH_LO_IDX] = value; }
+    void SetFmiFrameHashHi(fmi2Integer value) { integer_vars_[FMI_INTEGER_FRAME_HASH_HI_IDX] = value; }
+    fmi2Integer FmiHashMismatches() { return integer_vars_[FMI_INTEGER_HASH_MISMATCHES_IDX]; }
+    void SetFmiHashMismatches(fmi2Integer value) { integer_vars_[FMI_INTEGER_HASH_MISMATCHES_IDX] = value; }
     string FmiTracePath() { return string_vars_[FMI_STRING_TRACE_PATH_IDX]; }
     string FmiTraceName() { return string_vars_[FMI_STRING_TRACE_NAME_IDX]; }
+    string FmiStaticTraceName() { return string_vars_[FMI_STRING_STATIC_TRACE_NAME_IDX]; }
+    string FmiRecordPath() { return string_vars_[FMI_STRING_RECORD_PATH_IDX]; }
+    string FmiWorkerCpus() { return string_vars_[FMI_STRING_WORKER_CPUS_IDX]; }
+    void SetFmiWorkerPlacement(const string& value) { string_vars_[FMI_STRING_WORKER_PLACEMENT_IDX] = value; }
 
     /* Protocol Buffer Accessors */
-    void SetFmiSensorViewOut(const osi3::SensorView& data);
-    void SetFmiSensorDataOut(const osi3::SensorData& data);
-    void SetFmiGroundTruthOut(const osi3::GroundTruth& data);
+    template <typename T>
+    void SerializeToBuffer(const T& data);
+    void SerializeToBuffer(osi3::SensorView& data);
+    void SerializeToBuffer(osi3::GroundTruth& data);
+    void PublishBuffer(int base_lo_idx, int base_hi_idx, int size_idx);
+    void ResetSynthesizedSensorView();
+
+    /* Message Type Specialization */
+    static PublishFunction ResolvePublishFrame(osi3::ReaderTopLevelMessage message_type);
+    template <typename T>
+    fmi2Status PublishFrame(osi3::ReadResult& frame);
+    template <typename T>
+    bool TransformToEgo(T& data);
+    bool TransformToEgo(osi3::SensorView& data);
+    bool TransformToEgo(osi3::GroundTruth& data);
+    fmi2Status PublishStreamingUpdates(fmi2Real current_communication_point, bool& updated);
+
+    /* Delta-compressed Traces */
+    static bool LoadStaticPrefix(const std::filesystem::path& static_trace_path, string& static_prefix);
+    static std::shared_ptr<const SharedTraceState> AcquireSharedTraceState(const std::filesystem::path& trace_path, const std::filesystem::path& static_trace_path);
+
+    /* Trace Opening */
+    static OpenedTrace OpenTrace(const std::filesystem::path& folder_path, const string& trace_name, const string& static_trace_name, const ThreadPlacement& placement);
+    static OpenedTrace OpenTraceFiles(const std::filesystem::path& folder_path, const string& trace_name, const string& static_trace_name, const ThreadPlacement& placement);
+    void StartTraceOpen();
+    bool AwaitTraceOpen();
+
+    /* Trace Readahead */
+    std::optional<osi3::ReadResult> ReadRecord();
+
+    /* Corrupt Records */
+    std::optional<osi3::ReadResult> ReadFrame(bool* held = nullptr);
+    void UseRecordReader();
+    bool ResyncTrace();
+    void ResetTraceReader();
+    void HashFrame(const string& buffer, bool published);
+
+    /* Interpolated Playback */
+    fmi2Status InterpolateFrame(fmi2Real current_communication_point, osi3::ReadResult*& frame);
+    void ResetInterpolation();
+
+    /* Memory Budget */
+    size_t MemoryBudget();
+    size_t MemoryUsage();
+    void ShrinkFrameBuffer(size_t frame_size);
+    bool UpdateMemoryUsage();
+    bool CacheStaticContent() { return FmiCacheStaticContent() && !FmiEgoCoordinates() && !static_content_over_budget_; }
+
+    /* Worker Thread Placement */
+    void BindFrameBuffer(const string& buffer);
 
-    void ResetFmiSensorViewOut();
-    void ResetFmiSensorDataOut();
-    void ResetFmiGroundTruthOut();
+    /* Static Content Cache */
+    uint64_t StaticContentDigest(osi3::ReaderTopLevelMessage message_type);
+    const string& CachedStaticContent();
+    void AppendGroundTruth(osi3::GroundTruth& ground_truth, string* buffer, int field_number);
+    void ResetStaticContentCache();
 };
 #endif
 
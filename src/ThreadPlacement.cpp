@@ -0,0 +1,165 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "ThreadPlacement.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef __linux__
+/* Values of MPOL_PREFERRED and MPOL_MF_MOVE from linux/mempolicy.h, used
+ * directly to avoid a dependency on libnuma */
+constexpr int kMemoryPolicyPreferred = 1;
+constexpr unsigned kMemoryPolicyMove = 2;
+constexpr size_t kMaxNumaNodes = 1024;
+constexpr size_t kBitsPerMaskWord = 8 * sizeof(unsigned long);
+
+bool ParseCpuList(const std::string& cpus, cpu_set_t& cpu_set)
+{
+    CPU_ZERO(&cpu_set);
+    size_t position = 0;
+    while (position < cpus.size())
+    {
+        char* end = nullptr;
+        const long first = std::strtol(cpus.c_str() + position, &end, 10);
+        long last = first;
+        if (end == cpus.c_str() + position || first < 0)
+        {
+            return false;
+        }
+        if (*end == '-')
+        {
+            const char* const range_start = end + 1;
+            last = std::strtol(range_start, &end, 10);
+            if (end == range_start || last < first)
+            {
+                return false;
+            }
+        }
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+        {
+            CPU_SET(cpu, &cpu_set);
+        }
+        position = end - cpus.c_str();
+        if (position < cpus.size() && cpus[position] != ',')
+        {
+            return false;
+        }
+        position++;
+    }
+    return CPU_COUNT(&cpu_set) > 0;
+}
+#endif
+}  // namespace
+
+ThreadPlacement ThreadPlacement::FromParameters(const std::string& cpus, int numa_node)
+{
+    ThreadPlacement placement;
+    placement.cpus_ = cpus;
+    placement.numa_node_ = numa_node;
+
+    const char* const cpus_override = std::getenv("OSMP_TRACE_FILE_PLAYER_CPUS");
+    if (cpus_override != nullptr && *cpus_override != '\0')
+    {
+        placement.cpus_ = cpus_override;
+    }
+    const char* const numa_node_override = std::getenv("OSMP_TRACE_FILE_PLAYER_NUMA_NODE");
+    if (numa_node_override != nullptr && *numa_node_override != '\0')
+    {
+        char* end = nullptr;
+        errno = 0;
+        const long numa_node_value = std::strtol(numa_node_override, &end, 10);
+        if (*end != '\0' || errno != 0 || numa_node_value < -1 || numa_node_value > INT_MAX)
+        {
+            std::cerr << "Ignoring invalid OSMP_TRACE_FILE_PLAYER_NUMA_NODE " << numa_node_override << std::endl;
+        }
+        else
+        {
+            placement.numa_node_ = static_cast<int>(numa_node_value);
+        }
+    }
+
+    if (placement.cpus_.empty() && placement.numa_node_ >= 0)
+    {
+        std::ifstream node_cpus("/sys/devices/system/node/node" + std::to_string(placement.numa_node_) + "/cpulist");
+        std::getline(node_cpus, placement.cpus_);
+    }
+    return placement;
+}
+
+bool ThreadPlacement::ApplyToCurrentThread() const
+{
+    if (IsDefault())
+    {
+        return true;
+    }
+#ifdef __linux__
+    bool success = true;
+    if (!cpus_.empty())
+    {
+        cpu_set_t cpu_set;
+        success = ParseCpuList(cpus_, cpu_set) && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+    if (numa_node_ >= 0 && static_cast<size_t>(numa_node_) < kMaxNumaNodes)
+    {
+        unsigned long node_mask[kMaxNumaNodes / kBitsPerMaskWord] = {};
+        node_mask[numa_node_ / kBitsPerMaskWord] = 1UL << (numa_node_ % kBitsPerMaskWord);
+        success = syscall(SYS_set_mempolicy, kMemoryPolicyPreferred, node_mask, kMaxNumaNodes) == 0 && success;
+    }
+    return success;
+#else
+    return false;
+#endif
+}
+
+void ThreadPlacement::BindMemory(const void* address, size_t size) const
+{
+#ifdef __linux__
+    if (numa_node_ < 0 || static_cast<size_t>(numa_node_) >= kMaxNumaNodes)
+    {
+        return;
+    }
+
+    /* Only whole pages inside the range can be bound */
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(address) + page_size - 1) & ~(page_size - 1);
+    const auto end = (reinterpret_cast<uintptr_t>(address) + size) & ~(page_size - 1);
+    if (end <= begin)
+    {
+        return;
+    }
+
+    unsigned long node_mask[kMaxNumaNodes / kBitsPerMaskWord] = {};
+    node_mask[numa_node_ / kBitsPerMaskWord] = 1UL << (numa_node_ % kBitsPerMaskWord);
+    syscall(SYS_mbind, begin, end - begin, kMemoryPolicyPreferred, node_mask, kMaxNumaNodes, kMemoryPolicyMove);
+#endif
+}
+
+std::string ThreadPlacement::Describe() const
+{
+    if (IsDefault())
+    {
+        return "default";
+    }
+    std::string description = "cpus=" + (cpus_.empty() ? std::string("all") : cpus_);
+    description += " numa_node=" + (numa_node_ < 0 ? std::string("any") : std::to_string(numa_node_));
+#ifndef __linux__
+    description += " (not supported on this platform)";
+#endif
+    return description;
+}
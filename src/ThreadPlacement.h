@@ -0,0 +1,40 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+#ifndef ThreadPlacement_H_
+#define ThreadPlacement_H_
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Worker Thread Placement
+ *
+ * Describes on which CPUs the worker threads of the player (trace opening,
+ * recording) run and from which NUMA node their memory and the frame
+ * buffers are preferably allocated.  The CPUs are given as list like
+ * "0-3,8"; if only a NUMA node is given, the CPUs of that node are used.
+ * The environment variables OSMP_TRACE_FILE_PLAYER_CPUS and
+ * OSMP_TRACE_FILE_PLAYER_NUMA_NODE override the FMI parameters; a NUMA node
+ * which is not an integer of at least -1 is reported and ignored.
+ *
+ * Placement is only implemented for Linux; on other platforms the requested
+ * placement is reported as unsupported and ignored.
+ */
+class ThreadPlacement
+{
+  public:
+    static ThreadPlacement FromParameters(const std::string& cpus, int numa_node);
+
+    bool IsDefault() const { return cpus_.empty() && numa_node_ < 0; }
+    bool ApplyToCurrentThread() const;
+    void BindMemory(const void* address, size_t size) const;
+    std::string Describe() const;
+
+  private:
+    std::string cpus_;
+    int numa_node_ = -1;
+};
+
+#endif
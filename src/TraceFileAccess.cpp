@@ -0,0 +1,441 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "TraceFileAccess.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/wire_format.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "osi_groundtruth.pb.h"
+#include "osi_hostvehicledata.pb.h"
+#include "osi_sensordata.pb.h"
+#include "osi_sensorview.pb.h"
+#include "osi_streamingupdate.pb.h"
+#include "osi_trafficcommand.pb.h"
+#include "osi_trafficupdate.pb.h"
+
+using google::protobuf::internal::WireFormat;
+using google::protobuf::internal::WireFormatLite;
+
+namespace
+{
+constexpr size_t kSizePrefixLength = 4;
+constexpr size_t kMaxTagLength = 5;
+constexpr size_t kTimestampScanLength = 256;
+
+uint32_t DecodeSize(const char* data)
+{
+    uint32_t size = 0;
+    for (size_t i = 0; i < kSizePrefixLength; i++)
+    {
+        size |= static_cast<uint32_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return size;
+}
+
+/* Scans the top-level fields of an encoded message for the timestamp,
+ * without parsing the rest of the message */
+bool ScanTimestamp(const std::string& data, int field_number, int64_t& timestamp)
+{
+    google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(data.data()), static_cast<int>(data.size()));
+    uint32_t tag = 0;
+    while ((tag = input.ReadTag()) != 0)
+    {
+        if (WireFormatLite::GetTagFieldNumber(tag) == field_number && WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED)
+        {
+            uint32_t length = 0;
+            osi3::Timestamp value;
+            if (!input.ReadVarint32(&length))
+            {
+                return false;
+            }
+            const auto limit = input.PushLimit(static_cast<int>(length));
+            if (!value.ParseFromCodedStream(&input) || !input.ConsumedEntireMessage())
+            {
+                return false;
+            }
+            input.PopLimit(limit);
+            timestamp = value.seconds() * 1000000000 + value.nanos();
+            return true;
+        }
+        if (!WireFormatLite::SkipField(&input, tag))
+        {
+            return false;
+        }
+    }
+    return false;
+}
+}  // namespace
+
+std::filesystem::path FindTraceFile(const std::filesystem::path& folder_path)
+{
+    /* Directory scans are cached across all instances of the process, keyed
+     * by the modification time of the directory, which changes whenever
+     * files are added, removed or renamed */
+    struct CachedScan
+    {
+        std::filesystem::file_time_type modified;
+        std::filesystem::path trace_file_name;
+    };
+    static std::mutex cache_mutex;
+    static std::map<std::string, CachedScan> cache;
+
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(folder_path, error);
+    if (error)
+    {
+        return {};
+    }
+
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+    const auto cached = cache.find(folder_path.string());
+    if (cached != cache.end() && cached->second.modified == modified)
+    {
+        return cached->second.trace_file_name;
+    }
+
+    std::filesystem::path trace_file_name;
+    for (const auto& entry : std::filesystem::directory_iterator(folder_path, error))
+    {
+        if (entry.path().extension() == ".osi")
+        {
+            trace_file_name = entry.path().filename();
+            break;
+        }
+    }
+    if (trace_file_name.empty())
+    {
+        cache.erase(folder_path.string());
+    }
+    else
+    {
+        cache[folder_path.string()] = CachedScan{modified, trace_file_name};
+    }
+    return trace_file_name;
+}
+
+osi3::ReaderTopLevelMessage TraceFileMessageType(const std::filesystem::path& trace_path)
+{
+    static const std::map<std::string, osi3::ReaderTopLevelMessage> kTypeTokens = {
+        {"gt", osi3::ReaderTopLevelMessage::kGroundTruth},
+        {"sv", osi3::ReaderTopLevelMessage::kSensorView},
+        {"sd", osi3::ReaderTopLevelMessage::kSensorData},
+        {"hvd", osi3::ReaderTopLevelMessage::kHostVehicleData},
+        {"tc", osi3::ReaderTopLevelMessage::kTrafficCommand},
+        {"tu", osi3::ReaderTopLevelMessage::kTrafficUpdate},
+        {"su", osi3::ReaderTopLevelMessage::kStreamingUpdate},
+    };
+
+    const std::string stem = trace_path.stem().string();
+    size_t start = 0;
+    while (start <= stem.size())
+    {
+        const size_t end = std::min(stem.find('_', start), stem.size());
+        const auto type = kTypeTokens.find(stem.substr(start, end - start));
+        if (type != kTypeTokens.end())
+        {
+            return type->second;
+        }
+        start = end + 1;
+    }
+    return osi3::ReaderTopLevelMessage::kUnknown;
+}
+
+std::unique_ptr<google::protobuf::Message> NewTraceMessage(osi3::ReaderTopLevelMessage message_type)
+{
+    switch (message_type)
+    {
+        case osi3::ReaderTopLevelMessage::kGroundTruth:
+            return std::make_unique<osi3::GroundTruth>();
+        case osi3::ReaderTopLevelMessage::kSensorView:
+            return std::make_unique<osi3::SensorView>();
+        case osi3::ReaderTopLevelMessage::kSensorData:
+            return std::make_unique<osi3::SensorData>();
+        case osi3::ReaderTopLevelMessage::kHostVehicleData:
+            return std::make_unique<osi3::HostVehicleData>();
+        case osi3::ReaderTopLevelMessage::kTrafficCommand:
+            return std::make_unique<osi3::TrafficCommand>();
+        case osi3::ReaderTopLevelMessage::kTrafficUpdate:
+            return std::make_unique<osi3::TrafficUpdate>();
+        case osi3::ReaderTopLevelMessage::kStreamingUpdate:
+            return std::make_unique<osi3::StreamingUpdate>();
+        default:
+            return nullptr;
+    }
+}
+
+/*
+ * Trace File Index
+ */
+
+std::shared_ptr<const TraceFileIndex> TraceFileIndex::Build(const std::filesystem::path& trace_path)
+{
+    if (trace_path.extension() != ".osi")
+    {
+        std::cerr << "Random access is only supported for .osi trace files: " << trace_path.string() << std::endl;
+        return nullptr;
+    }
+    const osi3::ReaderTopLevelMessage message_type = TraceFileMessageType(trace_path);
+    const auto message = NewTraceMessage(message_type);
+    if (message == nullptr)
+    {
+        std::cerr << "Could not determine message type from trace file name " << trace_path.string() << std::endl;
+        return nullptr;
+    }
+    const auto* const timestamp_field = message->GetDescriptor()->FindFieldByName("timestamp");
+
+    std::ifstream file(trace_path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Could not open trace file " << trace_path.string() << std::endl;
+        return nullptr;
+    }
+    std::error_code error;
+    const uint64_t file_size = std::filesystem::file_size(trace_path, error);
+
+    auto index = std::make_shared<TraceFileIndex>();
+    index->trace_path_ = trace_path;
+    index->message_type_ = message_type;
+
+    std::string data;
+    char size_prefix[kSizePrefixLength];
+    uint64_t offset = 0;
+    int64_t timestamp = 0;
+    while (file.read(size_prefix, kSizePrefixLength))
+    {
+        const uint32_t size = DecodeSize(size_prefix);
+        offset += kSizePrefixLength;
+        if (offset + size > file_size)
+        {
+            std::cerr << "Truncated frame at offset " << offset << " in " << trace_path.string() << std::endl;
+            break;
+        }
+
+        /* Timestamps are among the first fields, so the leading bytes of a
+         * frame usually suffice; otherwise the whole frame is scanned */
+        data.resize(std::min<size_t>(size, kTimestampScanLength));
+        file.read(&data[0], static_cast<std::streamsize>(data.size()));
+        if (timestamp_field != nullptr && !ScanTimestamp(data, timestamp_field->number(), timestamp) && data.size() < size)
+        {
+            data.resize(size);
+            file.seekg(static_cast<std::streamoff>(offset));
+            file.read(&data[0], static_cast<std::streamsize>(size));
+            ScanTimestamp(data, timestamp_field->number(), timestamp);
+        }
+        index->frames_.push_back({offset, size, timestamp});
+
+        offset += size;
+        file.seekg(static_cast<std::streamoff>(offset));
+    }
+    return index;
+}
+
+std::pair<size_t, size_t> TraceFileIndex::FrameRange(int64_t first_timestamp, int64_t last_timestamp) const
+{
+    const auto first = std::partition_point(frames_.begin(), frames_.end(), [&](const Frame& frame) { return frame.timestamp < first_timestamp; });
+    const auto last = std::partition_point(first, frames_.end(), [&](const Frame& frame) { return frame.timestamp <= last_timestamp; });
+    return {static_cast<size_t>(first - frames_.begin()), static_cast<size_t>(last - frames_.begin())};
+}
+
+/*
+ * Trace File Cursor
+ */
+
+TraceFileCursor::TraceFileCursor(std::shared_ptr<const TraceFileIndex> index) : index_(std::move(index)), file_(index_->TracePath(), std::ios::binary) {}
+
+bool TraceFileCursor::Read(size_t frame, google::protobuf::Message& message)
+{
+    if (frame >= index_->FrameCount() || !file_.is_open())
+    {
+        return false;
+    }
+    const TraceFileIndex::Frame& entry = (*index_)[frame];
+    buffer_.resize(entry.size);
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(entry.offset));
+    if (!file_.read(&buffer_[0], static_cast<std::streamsize>(entry.size)))
+    {
+        return false;
+    }
+    return message.ParseFromString(buffer_);
+}
+
+std::unique_ptr<google::protobuf::Message> TraceFileCursor::Read(size_t frame)
+{
+    auto message = NewTraceMessage(index_->MessageType());
+    if (message == nullptr || !Read(frame, *message))
+    {
+        return nullptr;
+    }
+    return message;
+}
+
+/*
+ * Trace Record Reader
+ */
+
+TraceRecordReader::TraceRecordReader(osi3::ReaderTopLevelMessage message_type, uint64_t offset)
+    : message_type_(message_type), message_(NewTraceMessage(message_type)), offset_(offset)
+{
+}
+
+bool TraceRecordReader::Open(const std::filesystem::path& file_path)
+{
+    std::error_code error;
+    file_size_ = std::filesystem::file_size(file_path, error);
+    file_.open(file_path, std::ios::binary);
+    file_position_ = 0;
+    return message_ != nullptr && !error && file_.is_open();
+}
+
+std::optional<osi3::ReadResult> TraceRecordReader::ReadMessage()
+{
+    const auto start = std::chrono::steady_clock::now();
+    bool read = ReadAt(offset_, kSizePrefixLength, buffer_);
+    const uint32_t size = read ? DecodeSize(buffer_.data()) : 0;
+    read = read && IsPlausibleSize(offset_, size) && ReadAt(offset_ + kSizePrefixLength, size, buffer_);
+    last_read_time_ = std::chrono::steady_clock::now() - start;
+    if (!read)
+    {
+        return std::nullopt;
+    }
+
+    osi3::ReadResult result;
+    result.message = NewTraceMessage(message_type_);
+    result.message_type = message_type_;
+    if (!result.message->ParseFromString(buffer_))
+    {
+        return std::nullopt;
+    }
+    offset_ += kSizePrefixLength + size;
+    max_record_size_ = std::max(max_record_size_, size);
+    return result;
+}
+
+void TraceRecordReader::Close()
+{
+    file_.close();
+}
+
+bool TraceRecordReader::Resync()
+{
+    std::string window;
+    for (uint64_t start = offset_ + 1; start + kSizePrefixLength < file_size_; start += kResyncWindow)
+    {
+        /* Size prefix and first tag of every candidate offset in the window */
+        const size_t length = static_cast<size_t>(std::min<uint64_t>(kResyncWindow + kSizePrefixLength + kMaxTagLength, file_size_ - start));
+        if (!ReadAt(start, length, window))
+        {
+            break;
+        }
+        for (size_t i = 0; i < kResyncWindow && i + kSizePrefixLength < length; i++)
+        {
+            if (IsPlausibleResyncSize(start + i, DecodeSize(&window[i])) &&
+                IsPlausibleTag(&window[i + kSizePrefixLength], length - i - kSizePrefixLength) && IsRecordChainAt(start + i) && IsRecordAt(start + i))
+            {
+                offset_ = start + i;
+                return true;
+            }
+        }
+    }
+    offset_ = file_size_;
+    return false;
+}
+
+bool TraceRecordReader::IsPlausibleSize(uint64_t offset, uint32_t size) const
+{
+    return size > 0 && size <= kMaxRecordSize && offset + kSizePrefixLength + size <= file_size_;
+}
+
+bool TraceRecordReader::IsPlausibleResyncSize(uint64_t offset, uint32_t size) const
+{
+    /* Before any record was read, sizes are only bounded by kMaxRecordSize */
+    const uint64_t max_size = max_record_size_ == 0 ? kMaxRecordSize : std::max<uint64_t>(4ULL * max_record_size_, kMinResyncRecordSize);
+    return IsPlausibleSize(offset, size) && size <= max_size;
+}
+
+bool TraceRecordReader::IsPlausibleTag(const char* data, size_t length) const
+{
+    uint32_t tag = 0;
+    size_t i = 0;
+    for (; i < std::min(length, kMaxTagLength); i++)
+    {
+        tag |= static_cast<uint32_t>(static_cast<unsigned char>(data[i]) & 0x7FU) << (7 * i);
+        if ((static_cast<unsigned char>(data[i]) & 0x80U) == 0)
+        {
+            break;
+        }
+    }
+    if (i == std::min(length, kMaxTagLength))
+    {
+        return false;
+    }
+
+    const auto* const field = message_->GetDescriptor()->FindFieldByNumber(WireFormatLite::GetTagFieldNumber(tag));
+    if (field == nullptr)
+    {
+        return false;
+    }
+    const auto wire_type = WireFormatLite::GetTagWireType(tag);
+    return wire_type == WireFormat::WireTypeForFieldType(field->type()) || (field->is_packable() && wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}
+
+bool TraceRecordReader::ReadAt(uint64_t offset, size_t size, std::string& data)
+{
+    /* Sequential reads continue without a seek, which would drop the buffer of the stream */
+    data.resize(size);
+    if (offset != file_position_)
+    {
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>(offset));
+    }
+    const bool read = static_cast<bool>(file_.read(&data[0], static_cast<std::streamsize>(size)));
+    file_position_ = read ? offset + size : UINT64_MAX;
+    return read;
+}
+
+bool TraceRecordReader::IsRecordChainAt(uint64_t offset)
+{
+    std::string header;
+    uint64_t record_offset = offset;
+    for (int i = 0; i < kResyncChainLength && record_offset < file_size_; i++)
+    {
+        const size_t length = static_cast<size_t>(std::min<uint64_t>(kSizePrefixLength + kMaxTagLength, file_size_ - record_offset));
+        if (length <= kSizePrefixLength || !ReadAt(record_offset, length, header))
+        {
+            return false;
+        }
+        const uint32_t size = DecodeSize(header.data());
+        if (!IsPlausibleResyncSize(record_offset, size) || !IsPlausibleTag(&header[kSizePrefixLength], length - kSizePrefixLength))
+        {
+            return false;
+        }
+        record_offset += kSizePrefixLength + size;
+    }
+    return true;
+}
+
+bool TraceRecordReader::IsRecordAt(uint64_t offset)
+{
+    if (!ReadAt(offset, kSizePrefixLength, buffer_))
+    {
+        return false;
+    }
+    const uint32_t size = DecodeSize(buffer_.data());
+
+    /* The stream reads ahead of the record, so the next read has to seek */
+    file_position_ = UINT64_MAX;
+    google::protobuf::io::IstreamInputStream stream(&file_);
+    google::protobuf::io::CodedInputStream input(&stream);
+    input.PushLimit(static_cast<int>(size));
+    return message_->ParseFromCodedStream(&input) && input.ConsumedEntireMessage() && input.BytesUntilLimit() == 0;
+}
@@ -0,0 +1,167 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+#ifndef TraceFileAccess_H_
+#define TraceFileAccess_H_
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/message.h>
+
+#include "osi-utilities/tracefile/Reader.h"
+
+/*
+ * Random Access to Trace Files
+ *
+ * Trace discovery and random access to binary .osi traces, shared by the
+ * player FMU and analysis tools.
+ *
+ * TraceFileIndex scans a trace once and stores offset, size and timestamp
+ * of every frame.  The message type is taken from the file name following
+ * the OSI trace file naming convention (e.g. "..._gt_..._.osi").  Only the
+ * leading bytes of each frame are parsed to find its timestamp, so building
+ * the index costs little more than reading the record headers.  Timestamps
+ * are expected to be non-decreasing; frames without timestamp inherit the
+ * one of the previous frame.  An index is immutable once built and can be
+ * shared between threads.
+ *
+ * TraceFileCursor reads frames by number or by timestamp range through its
+ * own file handle.  Cursors are not thread-safe themselves, but any number
+ * of cursors on the same index can be used concurrently, e.g. one per
+ * thread scanning different ranges of the trace.
+ *
+ * TraceRecordReader reads a binary .osi trace sequentially from an arbitrary
+ * offset and can resynchronize behind corrupt records.
+ *
+ * MCAP traces are not supported, as the trace file reader does not expose
+ * the chunk index of MCAP files.
+ */
+
+std::filesystem::path FindTraceFile(const std::filesystem::path& folder_path);
+osi3::ReaderTopLevelMessage TraceFileMessageType(const std::filesystem::path& trace_path);
+std::unique_ptr<google::protobuf::Message> NewTraceMessage(osi3::ReaderTopLevelMessage message_type);
+
+class TraceFileIndex
+{
+  public:
+    struct Frame
+    {
+        uint64_t offset = 0;
+        uint32_t size = 0;
+        int64_t timestamp = 0;
+    };
+
+    static std::shared_ptr<const TraceFileIndex> Build(const std::filesystem::path& trace_path);
+
+    const std::filesystem::path& TracePath() const { return trace_path_; }
+    osi3::ReaderTopLevelMessage MessageType() const { return message_type_; }
+    size_t FrameCount() const { return frames_.size(); }
+    const Frame& operator[](size_t frame) const { return frames_[frame]; }
+    std::pair<size_t, size_t> FrameRange(int64_t first_timestamp, int64_t last_timestamp) const;
+
+  private:
+    std::filesystem::path trace_path_;
+    osi3::ReaderTopLevelMessage message_type_ = osi3::ReaderTopLevelMessage::kUnknown;
+    std::vector<Frame> frames_;
+};
+
+class TraceFileCursor
+{
+  public:
+    explicit TraceFileCursor(std::shared_ptr<const TraceFileIndex> index);
+
+    const TraceFileIndex& Index() const { return *index_; }
+    bool Read(size_t frame, google::protobuf::Message& message);
+    std::unique_ptr<google::protobuf::Message> Read(size_t frame);
+
+    /* Calls visitor(frame, message) for all frames with a timestamp in
+     * [first_timestamp, last_timestamp], reusing one message object; stops
+     * early if the visitor returns false.  Returns false on read errors. */
+    template <typename Visitor>
+    bool ForEachInRange(int64_t first_timestamp, int64_t last_timestamp, Visitor&& visitor)
+    {
+        const auto range = index_->FrameRange(first_timestamp, last_timestamp);
+        const auto message = NewTraceMessage(index_->MessageType());
+        if (message == nullptr)
+        {
+            return false;
+        }
+        for (size_t frame = range.first; frame < range.second; frame++)
+        {
+            if (!Read(frame, *message))
+            {
+                return false;
+            }
+            if (!visitor(frame, *message))
+            {
+                break;
+            }
+        }
+        return true;
+    }
+
+  private:
+    std::shared_ptr<const TraceFileIndex> index_;
+    std::ifstream file_;
+    std::string buffer_;
+};
+
+/* Resync() scans forward from the current offset for the next plausible
+ * record.  A candidate needs a chain of kResyncChainLength records (or fewer
+ * up to the end of the file), each with a size prefix within the file and
+ * within four times the largest record read so far, and a first field tag
+ * with a field number and wire type of the message type.  Only then is the
+ * candidate parsed, streaming from the file and stopping at the first
+ * error.  ReadMessage() does not advance past a record it fails to read.
+ * Record() is the encoded message of the last record read, LastReadTime()
+ * the time the last ReadMessage() spent reading the file, excluding
+ * parsing. */
+class TraceRecordReader : public osi3::TraceFileReader
+{
+  public:
+    TraceRecordReader(osi3::ReaderTopLevelMessage message_type, uint64_t offset);
+
+    bool Open(const std::filesystem::path& file_path) override;
+    std::optional<osi3::ReadResult> ReadMessage() override;
+    void Close() override;
+    bool HasNext() override { return offset_ < file_size_; }
+
+    bool Resync();
+    uint64_t Offset() const { return offset_; }
+    const std::string& Record() const { return buffer_; }
+    std::chrono::steady_clock::duration LastReadTime() const { return last_read_time_; }
+
+  private:
+    static constexpr uint32_t kMaxRecordSize = 256 << 20;
+    static constexpr uint32_t kMinResyncRecordSize = 64 << 10;
+    static constexpr size_t kResyncWindow = 1 << 20;
+    static constexpr int kResyncChainLength = 3;
+
+    bool IsPlausibleSize(uint64_t offset, uint32_t size) const;
+    bool IsPlausibleResyncSize(uint64_t offset, uint32_t size) const;
+    bool IsPlausibleTag(const char* data, size_t length) const;
+    bool ReadAt(uint64_t offset, size_t size, std::string& data);
+    bool IsRecordChainAt(uint64_t offset);
+    bool IsRecordAt(uint64_t offset);
+
+    osi3::ReaderTopLevelMessage message_type_;
+    std::unique_ptr<google::protobuf::Message> message_;
+    std::ifstream file_;
+    uint64_t file_size_ = 0;
+    uint64_t offset_;
+    uint64_t file_position_ = 0;
+    uint32_t max_record_size_ = 0;
+    std::string buffer_;
+    std::chrono::steady_clock::duration last_read_time_{};
+};
+
+#endif
@@ -0,0 +1,104 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "TraceReadahead.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+TraceReadahead::~TraceReadahead()
+{
+    Close();
+}
+
+void TraceReadahead::Open(const std::filesystem::path& path, bool drop_consumed)
+{
+    Close();
+#ifdef __linux__
+    std::error_code error;
+    file_size_ = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return;
+    }
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0)
+    {
+        return;
+    }
+    drop_consumed_ = drop_consumed && path.extension() == ".osi";
+    Advance(0, false);
+#else
+    (void)path;
+    (void)drop_consumed;
+#endif
+}
+
+void TraceReadahead::Advance(size_t consumed_bytes, bool stalled)
+{
+    if (fd_ < 0)
+    {
+        return;
+    }
+    consumed_ = std::min(consumed_ + consumed_bytes, file_size_);
+    if (stalled)
+    {
+        window_ = std::min(window_ * 2, kMaxWindow);
+    }
+
+    /* Refill once the reader has consumed half of the window */
+    const uint64_t target = std::min(consumed_ + window_, file_size_);
+    if (target > ahead_end_ && (target == file_size_ || target - ahead_end_ >= window_ / 2))
+    {
+        const uint64_t start = std::max(ahead_end_, consumed_);
+#ifdef __linux__
+        Advise(start, target - start, POSIX_FADV_WILLNEED);
+#endif
+        readahead_bytes_ += target - start;
+        ahead_end_ = target;
+    }
+
+    if (drop_consumed_ && consumed_ >= dropped_end_ + kDropBehind + kMinWindow)
+    {
+        const uint64_t drop_end = consumed_ - kDropBehind;
+#ifdef __linux__
+        Advise(dropped_end_, drop_end - dropped_end_, POSIX_FADV_DONTNEED);
+#endif
+        dropped_end_ = drop_end;
+    }
+}
+
+void TraceReadahead::Close()
+{
+#ifdef __linux__
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+#endif
+    fd_ = -1;
+    drop_consumed_ = false;
+    file_size_ = 0;
+    consumed_ = 0;
+    ahead_end_ = 0;
+    dropped_end_ = 0;
+    window_ = kMinWindow;
+    readahead_bytes_ = 0;
+}
+
+void TraceReadahead::Advise(uint64_t offset, uint64_t length, int advice) const
+{
+#ifdef __linux__
+    posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(length), advice);
+#else
+    (void)offset;
+    (void)length;
+    (void)advice;
+#endif
+}
@@ -0,0 +1,61 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+#ifndef TraceReadahead_H_
+#define TraceReadahead_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/*
+ * Trace Readahead
+ *
+ * Playback reads the trace strictly sequentially, but in small reads of one
+ * message each, which is slow on cold storage.  TraceReadahead follows the
+ * bytes consumed by the reader and asks the kernel to read the following
+ * window of the file into the page cache in the background.  The window
+ * starts small and is doubled on every read stall, up to kMaxWindow.  If
+ * requested for .osi traces, where the consumed offset is exact, the pages
+ * behind the reader are dropped from the page cache again, so that multi-GB
+ * traces do not evict the working set of other processes.  This is not done
+ * by default, as it also evicts the pages for other readers of the same
+ * trace, e.g. further instances of a parameter sweep.
+ *
+ * Readahead is only implemented for Linux; on other platforms it does
+ * nothing.
+ */
+class TraceReadahead
+{
+  public:
+    TraceReadahead() = default;
+    TraceReadahead(const TraceReadahead&) = delete;
+    TraceReadahead& operator=(const TraceReadahead&) = delete;
+    ~TraceReadahead();
+
+    void Open(const std::filesystem::path& path, bool drop_consumed);
+    void Advance(size_t consumed_bytes, bool stalled);
+    void Close();
+
+    bool IsOpen() const { return fd_ >= 0; }
+    uint64_t ReadaheadBytes() const { return readahead_bytes_; }
+
+  private:
+    static constexpr uint64_t kMinWindow = 1 << 20;
+    static constexpr uint64_t kMaxWindow = 64 << 20;
+    static constexpr uint64_t kDropBehind = 1 << 20;
+
+    void Advise(uint64_t offset, uint64_t length, int advice) const;
+
+    int fd_ = -1;
+    bool drop_consumed_ = false;
+    uint64_t file_size_ = 0;
+    uint64_t consumed_ = 0;
+    uint64_t ahead_end_ = 0;
+    uint64_t dropped_end_ = 0;
+    uint64_t window_ = kMinWindow;
+    uint64_t readahead_bytes_ = 0;
+};
+
+#endif
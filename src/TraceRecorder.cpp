@@ -0,0 +1,174 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr size_t kFileBufferSize = 4 * 1024 * 1024;
+constexpr size_t kSizePrefixLength = 4;
+constexpr size_t kMinShrinkCapacity = 64 * 1024;
+}  // namespace
+
+TraceRecorder::~TraceRecorder()
+{
+    Close();
+}
+
+bool TraceRecorder::Open(const std::filesystem::path& path, const ThreadPlacement& placement, size_t max_buffered_bytes)
+{
+    Close();
+    placement_ = placement;
+    max_buffered_bytes_ = max_buffered_bytes;
+#ifdef _WIN32
+    file_ = _wfopen(path.c_str(), L"wb");
+#else
+    file_ = std::fopen(path.c_str(), "wb");
+#endif
+    if (file_ == nullptr)
+    {
+        return false;
+    }
+    file_buffer_.resize(max_buffered_bytes_ != 0 ? std::min(kFileBufferSize, max_buffered_bytes_ / 2) : kFileBufferSize);
+    std::setvbuf(file_, file_buffer_.data(), _IOFBF, file_buffer_.size());
+
+    stopping_ = false;
+    failed_ = false;
+    writer_ = std::thread(&TraceRecorder::Run, this);
+    return true;
+}
+
+void TraceRecorder::Write(const std::string& message)
+{
+    const size_t record_size = kSizePrefixLength + message.size();
+    std::string record;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (max_buffered_bytes_ != 0)
+        {
+            drained_.wait(lock, [&] { return queued_bytes_ == 0 || queued_bytes_ + record_size <= max_buffered_bytes_; });
+        }
+        if (!free_.empty())
+        {
+            record.swap(free_.back());
+            free_.pop_back();
+            free_bytes_ -= record.capacity();
+        }
+    }
+
+    /* Do not keep the buffer of an outlier message for all later messages */
+    if (record.capacity() > kMinShrinkCapacity && record.capacity() > 2 * record_size)
+    {
+        std::string().swap(record);
+    }
+
+    const auto size = static_cast<uint32_t>(message.size());
+    const size_t capacity = record.capacity();
+    record.resize(record_size);
+    if (record.capacity() != capacity)
+    {
+        placement_.BindMemory(record.data(), record.capacity());
+    }
+    for (size_t i = 0; i < kSizePrefixLength; i++)
+    {
+        record[i] = static_cast<char>((size >> (8 * i)) & 0xFFU);
+    }
+    std::memcpy(&record[kSizePrefixLength], message.data(), message.size());
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        queued_bytes_ += record.capacity();
+        queue_.push_back(std::move(record));
+    }
+    wakeup_.notify_one();
+}
+
+bool TraceRecorder::Close()
+{
+    if (file_ == nullptr)
+    {
+        return true;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    writer_.join();
+
+    bool success = !failed_ && std::fflush(file_) == 0;
+#ifdef _WIN32
+    success = success && _commit(_fileno(file_)) == 0;
+#else
+    success = success && fsync(fileno(file_)) == 0;
+#endif
+    success = std::fclose(file_) == 0 && success;
+    file_ = nullptr;
+    std::vector<char>().swap(file_buffer_);
+    queue_.clear();
+    free_.clear();
+    queued_bytes_ = 0;
+    free_bytes_ = 0;
+    return success;
+}
+
+size_t TraceRecorder::MemoryUsage()
+{
+    const std::lock_guard<std::mutex> lock(mutex_);
+    return file_buffer_.capacity() + queued_bytes_ + free_bytes_;
+}
+
+void TraceRecorder::Run()
+{
+    if (!placement_.ApplyToCurrentThread())
+    {
+        std::cerr << "Could not apply worker placement " << placement_.Describe() << " to recording thread" << std::endl;
+    }
+
+    std::vector<std::string> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wakeup_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty())
+        {
+            return;
+        }
+        batch.swap(queue_);
+        lock.unlock();
+
+        bool failed = false;
+        for (const auto& record : batch)
+        {
+            failed |= std::fwrite(record.data(), 1, record.size(), file_) != record.size();
+        }
+
+        lock.lock();
+        failed_ |= failed;
+        for (auto& record : batch)
+        {
+            queued_bytes_ -= record.capacity();
+            if (max_buffered_bytes_ == 0 || queued_bytes_ + free_bytes_ + record.capacity() <= max_buffered_bytes_)
+            {
+                free_bytes_ += record.capacity();
+                free_.push_back(std::move(record));
+            }
+        }
+        batch.clear();
+        drained_.notify_all();
+    }
+}
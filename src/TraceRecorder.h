@@ -0,0 +1,66 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+#ifndef TraceRecorder_H_
+#define TraceRecorder_H_
+
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ThreadPlacement.h"
+
+/*
+ * Trace Recording
+ *
+ * Appends serialized OSI messages to a binary .osi trace file, i.e. each
+ * message is prefixed with its size as 32 bit little-endian integer.
+ * Write() only copies the message into a recycled buffer and queues it; a
+ * background thread writes all queued messages in one batch through a large
+ * stdio buffer, so recording does not add file I/O latency to the caller.
+ * Close() drains the queue and syncs the file to disk.  The writer thread
+ * and the queued buffers follow the given worker placement.
+ *
+ * If max_buffered_bytes is not 0, the queued and recycled buffers are kept
+ * below this size: Write() waits for the writer thread while the queue is
+ * full, and recycled buffers beyond the limit are released.
+ */
+class TraceRecorder
+{
+  public:
+    TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    ~TraceRecorder();
+
+    bool Open(const std::filesystem::path& path, const ThreadPlacement& placement, size_t max_buffered_bytes);
+    bool IsOpen() const { return file_ != nullptr; }
+    void Write(const std::string& message);
+    bool Close();
+    size_t MemoryUsage();
+
+  private:
+    void Run();
+
+    FILE* file_ = nullptr;
+    ThreadPlacement placement_;
+    std::vector<char> file_buffer_;
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable drained_;
+    std::vector<std::string> queue_;
+    std::vector<std::string> free_;
+    size_t max_buffered_bytes_ = 0;
+    size_t queued_bytes_ = 0;
+    size_t free_bytes_ = 0;
+    bool stopping_ = false;
+    bool failed_ = false;
+};
+
+#endif
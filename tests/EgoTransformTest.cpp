@@ -0,0 +1,130 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Ego Transform Test
+ *
+ * The host vehicle is placed at (10, 5) heading north with its rear axle
+ * 1.4 m behind its center, i.e. at (10, 3.6).  All other geometry is placed
+ * at (10, 8) or, with orientation, at (10, 7) heading north, so it ends up
+ * straight ahead of the rear axle.
+ */
+
+#include <cmath>
+#include <cstdlib>
+
+#include "EgoTransform.h"
+#include "TestUtilities.h"
+
+namespace
+{
+constexpr double kPi = 3.141592653589793;
+
+bool Near(double a, double b)
+{
+    return std::abs(a - b) < 1e-9;
+}
+
+void SetPose(osi3::BaseStationary& base)
+{
+    base.mutable_position()->set_x(10.0);
+    base.mutable_position()->set_y(7.0);
+    base.mutable_orientation()->set_yaw(kPi / 2);
+}
+
+void CheckPose(const osi3::BaseStationary& base)
+{
+    CHECK(Near(base.position().x(), 3.4));
+    CHECK(Near(base.position().y(), 0.0));
+    CHECK(Near(base.orientation().yaw(), 0.0));
+}
+
+void SetPoint(osi3::Vector3d& point)
+{
+    point.set_x(10.0);
+    point.set_y(8.0);
+}
+
+void CheckPoint(const osi3::Vector3d& point)
+{
+    CHECK(Near(point.x(), 4.4));
+    CHECK(Near(point.y(), 0.0));
+}
+
+osi3::GroundTruth MakeGroundTruth()
+{
+    osi3::GroundTruth ground_truth;
+    ground_truth.mutable_host_vehicle_id()->set_value(1);
+    auto* host = ground_truth.add_moving_object();
+    host->mutable_id()->set_value(1);
+    host->mutable_base()->mutable_position()->set_x(10.0);
+    host->mutable_base()->mutable_position()->set_y(5.0);
+    host->mutable_base()->mutable_orientation()->set_yaw(kPi / 2);
+    host->mutable_base()->mutable_velocity()->set_y(20.0);
+    host->mutable_vehicle_attributes()->mutable_bbcenter_to_rear()->set_x(-1.4);
+
+    SetPose(*ground_truth.add_stationary_object()->mutable_base());
+    ground_truth.add_stationary_object();
+    auto* traffic_sign = ground_truth.add_traffic_sign();
+    SetPose(*traffic_sign->mutable_main_sign()->mutable_base());
+    SetPose(*traffic_sign->add_supplementary_sign()->mutable_base());
+    SetPose(*ground_truth.add_traffic_light()->mutable_base());
+    SetPose(*ground_truth.add_road_marking()->mutable_base());
+
+    SetPoint(*ground_truth.add_lane()->mutable_classification()->add_centerline());
+    SetPoint(*ground_truth.add_lane_boundary()->add_boundary_line()->mutable_position());
+    SetPoint(*ground_truth.add_logical_lane_boundary()->add_boundary_line()->mutable_position());
+    auto* reference_line_point = ground_truth.add_reference_line()->add_poly_line();
+    SetPoint(*reference_line_point->mutable_world_position());
+    reference_line_point->set_t_axis_yaw(kPi);
+    return ground_truth;
+}
+
+void TestTransform()
+{
+    EgoTransform transform;
+    const osi3::GroundTruth original = MakeGroundTruth();
+    /* The second run reuses the buffers of the first one */
+    for (int run = 0; run < 2; run++)
+    {
+        osi3::GroundTruth ground_truth = original;
+        CHECK(transform.Apply(ground_truth, 1));
+
+        const auto& host = ground_truth.moving_object(0).base();
+        CHECK(Near(host.position().x(), 1.4));
+        CHECK(Near(host.position().y(), 0.0));
+        CHECK(Near(host.orientation().yaw(), 0.0));
+        CHECK(Near(host.velocity().x(), 20.0));
+        CHECK(Near(host.velocity().y(), 0.0));
+
+        CheckPose(ground_truth.stationary_object(0).base());
+        CHECK(!ground_truth.stationary_object(1).has_base());
+        CheckPose(ground_truth.traffic_sign(0).main_sign().base());
+        CheckPose(ground_truth.traffic_sign(0).supplementary_sign(0).base());
+        CheckPose(ground_truth.traffic_light(0).base());
+        CheckPose(ground_truth.road_marking(0).base());
+
+        CheckPoint(ground_truth.lane(0).classification().centerline(0));
+        CheckPoint(ground_truth.lane_boundary(0).boundary_line(0).position());
+        CheckPoint(ground_truth.logical_lane_boundary(0).boundary_line(0).position());
+        CheckPoint(ground_truth.reference_line(0).poly_line(0).world_position());
+        CHECK(Near(ground_truth.reference_line(0).poly_line(0).t_axis_yaw(), kPi / 2));
+    }
+}
+
+void TestMissingHostVehicle()
+{
+    EgoTransform transform;
+    osi3::GroundTruth ground_truth = MakeGroundTruth();
+    CHECK(!transform.Apply(ground_truth, 2));
+}
+}  // namespace
+
+int main()
+{
+    TestTransform();
+    TestMissingHostVehicle();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#include "FmuDriver.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "TestUtilities.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace
+{
+void Logger(fmi2ComponentEnvironment /*environment*/, fmi2String instance_name, fmi2Status status, fmi2String category, fmi2String message, ...)
+{
+    va_list arguments;
+    va_start(arguments, message);
+    std::fprintf(stderr, "%s [%s, %d]: ", instance_name, category, static_cast<int>(status));
+    std::vfprintf(stderr, message, arguments);
+    std::fprintf(stderr, "\n");
+    va_end(arguments);
+}
+
+const fmi2CallbackFunctions kCallbacks = {Logger, std::calloc, std::free, nullptr, nullptr};
+}  // namespace
+
+template <typename Function>
+Function* FmuDriver::Resolve(const char* name)
+{
+#ifdef _WIN32
+    auto* function = reinterpret_cast<Function*>(GetProcAddress(static_cast<HMODULE>(library_), name));
+#else
+    auto* function = reinterpret_cast<Function*>(dlsym(library_, name));
+#endif
+    if (function == nullptr)
+    {
+        std::fprintf(stderr, "Missing FMI function %s\n", name);
+    }
+    CHECK(function != nullptr);
+    return function;
+}
+
+FmuDriver::FmuDriver(const std::filesystem::path& library_path)
+{
+    /* The library stays loaded until the process exits, as it is shared by
+     * all instances */
+#ifdef _WIN32
+    library_ = LoadLibraryW(library_path.wstring().c_str());
+#else
+    library_ = dlopen(library_path.string().c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (library_ == nullptr)
+    {
+        std::fprintf(stderr, "%s\n", dlerror());
+    }
+#endif
+    CHECK(library_ != nullptr);
+
+    instantiate_ = Resolve<fmi2InstantiateTYPE>("fmi2Instantiate");
+    free_instance_ = Resolve<fmi2FreeInstanceTYPE>("fmi2FreeInstance");
+    setup_experiment_ = Resolve<fmi2SetupExperimentTYPE>("fmi2SetupExperiment");
+    enter_initialization_mode_ = Resolve<fmi2EnterInitializationModeTYPE>("fmi2EnterInitializationMode");
+    exit_initialization_mode_ = Resolve<fmi2ExitInitializationModeTYPE>("fmi2ExitInitializationMode");
+    terminate_ = Resolve<fmi2TerminateTYPE>("fmi2Terminate");
+    do_step_ = Resolve<fmi2DoStepTYPE>("fmi2DoStep");
+    get_boolean_ = Resolve<fmi2GetBooleanTYPE>("fmi2GetBoolean");
+    get_integer_ = Resolve<fmi2GetIntegerTYPE>("fmi2GetInteger");
+    get_real_ = Resolve<fmi2GetRealTYPE>("fmi2GetReal");
+    set_boolean_ = Resolve<fmi2SetBooleanTYPE>("fmi2SetBoolean");
+    set_integer_ = Resolve<fmi2SetIntegerTYPE>("fmi2SetInteger");
+    set_string_ = Resolve<fmi2SetStringTYPE>("fmi2SetString");
+
+    component_ = instantiate_("player", fmi2CoSimulation, "", "", &kCallbacks, fmi2False, fmi2False);
+    CHECK(component_ != nullptr);
+}
+
+FmuDriver::~FmuDriver()
+{
+    terminate_(component_);
+    free_instance_(component_);
+}
+
+void FmuDriver::SetBoolean(fmi2ValueReference value_reference, bool value)
+{
+    const fmi2Boolean boolean = value ? fmi2True : fmi2False;
+    CHECK(set_boolean_(component_, &value_reference, 1, &boolean) == fmi2OK);
+}
+
+void FmuDriver::SetInteger(fmi2ValueReference value_reference, fmi2Integer value)
+{
+    CHECK(set_integer_(component_, &value_reference, 1, &value) == fmi2OK);
+}
+
+void FmuDriver::SetString(fmi2ValueReference value_reference, const std::string& value)
+{
+    const fmi2String string = value.c_str();
+    CHECK(set_string_(component_, &value_reference, 1, &string) == fmi2OK);
+}
+
+fmi2Status FmuDriver::Initialize()
+{
+    CHECK(setup_experiment_(component_, fmi2False, 0.0, 0.0, fmi2False, 0.0) == fmi2OK);
+    CHECK(enter_initialization_mode_(component_) == fmi2OK);
+    return exit_initialization_mode_(component_);
+}
+
+fmi2Status FmuDriver::DoStep(fmi2Real current_time, fmi2Real step_size)
+{
+    return do_step_(component_, current_time, step_size, fmi2True);
+}
+
+fmi2Boolean FmuDriver::GetBoolean(fmi2ValueReference value_reference) const
+{
+    fmi2Boolean value = fmi2False;
+    CHECK(get_boolean_(component_, &value_reference, 1, &value) == fmi2OK);
+    return value;
+}
+
+fmi2Integer FmuDriver::GetInteger(fmi2ValueReference value_reference) const
+{
+    fmi2Integer value = 0;
+    CHECK(get_integer_(component_, &value_reference, 1, &value) == fmi2OK);
+    return value;
+}
+
+fmi2Real FmuDriver::GetReal(fmi2ValueReference value_reference) const
+{
+    fmi2Real value = 0.0;
+    CHECK(get_real_(component_, &value_reference, 1, &value) == fmi2OK);
+    return value;
+}
+
+std::string FmuDriver::Output(fmi2ValueReference base_lo) const
+{
+    const fmi2ValueReference value_references[3] = {base_lo, base_lo + 1, base_lo + 2};
+    fmi2Integer values[3] = {0, 0, 0};
+    CHECK(get_integer_(component_, value_references, 3, values) == fmi2OK);
+    const uint64_t address = static_cast<uint64_t>(static_cast<uint32_t>(values[0])) | (static_cast<uint64_t>(static_cast<uint32_t>(values[1])) << 32U);
+    if (address == 0 || values[2] <= 0)
+    {
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(static_cast<uintptr_t>(address)), static_cast<size_t>(values[2]));
+}
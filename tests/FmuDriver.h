@@ -0,0 +1,92 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#ifndef FmuDriver_H_
+#define FmuDriver_H_
+
+#include <filesystem>
+#include <string>
+
+#include "fmi2Functions.h"
+
+/*
+ * FMU Driver
+ *
+ * Loads the shared library of the player FMU and runs one instance of it
+ * through the FMI 2.0 co-simulation interface, like a simulation master
+ * does.  Parameters are set before Initialize(), the OSMP outputs are read
+ * by the value reference of their base.lo variable.  The value references
+ * below are those of modelDescription.xml.
+ */
+
+namespace PlayerVariables
+{
+/* Boolean */
+constexpr fmi2ValueReference kValid = 0;
+constexpr fmi2ValueReference kCacheStaticContent = 1;
+constexpr fmi2ValueReference kEgoCoordinates = 2;
+constexpr fmi2ValueReference kSynthesizeSensorView = 3;
+constexpr fmi2ValueReference kInterpolate = 4;
+constexpr fmi2ValueReference kHashFrames = 5;
+
+/* Integer */
+constexpr fmi2ValueReference kSensorViewOut = 0;
+constexpr fmi2ValueReference kOnCorruptRecord = 10;
+constexpr fmi2ValueReference kSkippedRecords = 11;
+constexpr fmi2ValueReference kOutputBufferReallocations = 24;
+
+/* Real */
+constexpr fmi2ValueReference kMeanStepTime = 7;
+
+/* String */
+constexpr fmi2ValueReference kTracePath = 0;
+constexpr fmi2ValueReference kTraceName = 1;
+constexpr fmi2ValueReference kStaticTraceName = 2;
+constexpr fmi2ValueReference kRecordPath = 3;
+}  // namespace PlayerVariables
+
+class FmuDriver
+{
+  public:
+    explicit FmuDriver(const std::filesystem::path& library_path);
+    ~FmuDriver();
+    FmuDriver(const FmuDriver&) = delete;
+    FmuDriver& operator=(const FmuDriver&) = delete;
+
+    void SetBoolean(fmi2ValueReference value_reference, bool value);
+    void SetInteger(fmi2ValueReference value_reference, fmi2Integer value);
+    void SetString(fmi2ValueReference value_reference, const std::string& value);
+    fmi2Status Initialize();
+    fmi2Status DoStep(fmi2Real current_time, fmi2Real step_size);
+    fmi2Boolean GetBoolean(fmi2ValueReference value_reference) const;
+    fmi2Integer GetInteger(fmi2ValueReference value_reference) const;
+    fmi2Real GetReal(fmi2ValueReference value_reference) const;
+    /* Copy of the buffer published on the OSMP output whose base.lo
+     * variable has the given value reference */
+    std::string Output(fmi2ValueReference base_lo) const;
+
+  private:
+    template <typename Function>
+    Function* Resolve(const char* name);
+
+    void* library_ = nullptr;
+    fmi2Component component_ = nullptr;
+
+    fmi2InstantiateTYPE* instantiate_ = nullptr;
+    fmi2FreeInstanceTYPE* free_instance_ = nullptr;
+    fmi2SetupExperimentTYPE* setup_experiment_ = nullptr;
+    fmi2EnterInitializationModeTYPE* enter_initialization_mode_ = nullptr;
+    fmi2ExitInitializationModeTYPE* exit_initialization_mode_ = nullptr;
+    fmi2TerminateTYPE* terminate_ = nullptr;
+    fmi2DoStepTYPE* do_step_ = nullptr;
+    fmi2GetBooleanTYPE* get_boolean_ = nullptr;
+    fmi2GetIntegerTYPE* get_integer_ = nullptr;
+    fmi2GetRealTYPE* get_real_ = nullptr;
+    fmi2SetBooleanTYPE* set_boolean_ = nullptr;
+    fmi2SetIntegerTYPE* set_integer_ = nullptr;
+    fmi2SetStringTYPE* set_string_ = nullptr;
+};
+
+#endif
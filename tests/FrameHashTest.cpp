@@ -0,0 +1,91 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Frame Hash Test
+ *
+ * Checks FrameHash() against digests of the XXH64 reference implementation
+ * and the round trip of frame hash lists.
+ *
+ * Usage: FrameHashTest <directory for temporary files>
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "FrameHash.h"
+#include "TestUtilities.h"
+
+namespace
+{
+void TestReferenceDigests()
+{
+    const struct
+    {
+        const char* data;
+        uint64_t digest;
+    } kReferenceDigests[] = {
+        {"", 0xEF46DB3751D8E999ULL},
+        {"a", 0xD24EC4F1A98C6E5BULL},
+        {"abc", 0x44BC2CF5AD770999ULL},
+        {"Nobody inspects the spammish repetition", 0xFBCEA83C8A378BF1ULL},
+    };
+    for (const auto& reference : kReferenceDigests)
+    {
+        CHECK(FrameHash(reference.data, std::strlen(reference.data)) == reference.digest);
+    }
+}
+
+void TestUnalignedData()
+{
+    std::string data(1000, '\0');
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<char>(i * 7);
+    }
+    for (const size_t length : {1, 3, 4, 7, 8, 31, 32, 33, 63, 64, 100, 999})
+    {
+        const std::string unaligned = "x" + data.substr(0, length);
+        CHECK(FrameHash(unaligned.data() + 1, length) == FrameHash(data.data(), length));
+    }
+}
+
+void TestFrameHashLists(const std::filesystem::path& directory)
+{
+    const auto path = directory / "frame_hash_test.osi.xxh64";
+    const std::vector<uint64_t> hashes = {0, 1, 0xEF46DB3751D8E999ULL, ~0ULL};
+    CHECK(WriteFrameHashes(path, hashes));
+    std::vector<uint64_t> read_hashes;
+    CHECK(ReadFrameHashes(path, read_hashes));
+    CHECK(read_hashes == hashes);
+
+    std::ofstream(path) << "# comment\n\nef46db3751d8e999\n";
+    CHECK(ReadFrameHashes(path, read_hashes));
+    CHECK(read_hashes == std::vector<uint64_t>{0xEF46DB3751D8E999ULL});
+
+    std::ofstream(path) << "ef46db3751d8e999 frame\n";
+    CHECK(!ReadFrameHashes(path, read_hashes));
+    CHECK(!ReadFrameHashes(directory / "missing.xxh64", read_hashes));
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s <directory for temporary files>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::filesystem::create_directories(argv[1]);
+
+    TestReferenceDigests();
+    TestUnalignedData();
+    TestFrameHashLists(argv[1]);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,88 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Frame Interpolator Test
+ *
+ * Object 1 moves and turns from a yaw of 3.0 rad to -3.0 rad, i.e. by
+ * 0.28 rad across the wrap at pi.  Object 2 is missing in the next frame and
+ * object 3 only appears in it.
+ */
+
+#include <cmath>
+#include <cstdlib>
+
+#include "FrameInterpolator.h"
+#include "TestUtilities.h"
+
+namespace
+{
+constexpr double kPi = 3.141592653589793;
+
+bool Near(double a, double b)
+{
+    return std::abs(a - b) < 1e-9;
+}
+
+void AddObject(osi3::GroundTruth& ground_truth, uint64_t id, double x, double yaw)
+{
+    auto* object = ground_truth.add_moving_object();
+    object->mutable_id()->set_value(id);
+    object->mutable_base()->mutable_position()->set_x(x);
+    object->mutable_base()->mutable_velocity()->set_x(x);
+    object->mutable_base()->mutable_orientation()->set_yaw(yaw);
+}
+
+void TestInterpolation()
+{
+    osi3::GroundTruth previous;
+    AddObject(previous, 1, 0.0, 3.0);
+    AddObject(previous, 2, 5.0, 1.0);
+    osi3::GroundTruth next;
+    AddObject(next, 3, 50.0, 0.0);
+    AddObject(next, 1, 10.0, -3.0);
+
+    FrameInterpolator interpolator;
+    interpolator.Prepare(previous, &next);
+    const double turn = 2 * kPi - 6.0;
+    for (const double alpha : {0.0, 0.25, 0.75, 1.0})
+    {
+        osi3::GroundTruth frame = previous;
+        interpolator.Apply(frame, alpha);
+        CHECK(frame.moving_object_size() == 2);
+
+        const auto& object = frame.moving_object(0).base();
+        CHECK(Near(object.position().x(), 10.0 * alpha));
+        CHECK(Near(object.velocity().x(), 10.0 * alpha));
+        CHECK(Near(object.orientation().yaw(), std::remainder(3.0 + alpha * turn, 2 * kPi)));
+        CHECK(std::abs(object.orientation().yaw()) <= kPi);
+        CHECK(!object.has_acceleration());
+
+        const auto& missing_object = frame.moving_object(1).base();
+        CHECK(Near(missing_object.position().x(), 5.0));
+        CHECK(Near(missing_object.orientation().yaw(), 1.0));
+    }
+}
+
+void TestLastFrame()
+{
+    osi3::GroundTruth previous;
+    AddObject(previous, 1, 4.0, -2.0);
+
+    FrameInterpolator interpolator;
+    interpolator.Prepare(previous, nullptr);
+    osi3::GroundTruth frame = previous;
+    interpolator.Apply(frame, 0.5);
+    CHECK(Near(frame.moving_object(0).base().position().x(), 4.0));
+    CHECK(Near(frame.moving_object(0).base().orientation().yaw(), -2.0));
+}
+}  // namespace
+
+int main()
+{
+    TestInterpolation();
+    TestLastFrame();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Playback Test
+ *
+ * Plays the example trace and the traces generated by TestTraces through
+ * the FMU and checks that every published message equals the record of
+ * the trace byte for byte, or for delta-compressed traces the static record
+ * followed by the record of the frame, and that recordings equal the
+ * played trace.  With cached static content, the published fields are
+ * ordered differently, so these runs are only recorded here and compared
+ * with the complete frames by TestTraces.  Likewise, interpolated playback
+ * in ego coordinates is recorded here and checked by TestTraces.
+ *
+ * Usage: PlaybackTest <FMU library> <example trace> <directory of generated traces>
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "FmuDriver.h"
+#include "TestUtilities.h"
+
+using namespace PlayerVariables;
+
+namespace
+{
+std::filesystem::path g_library_path;
+std::filesystem::path g_trace_dir;
+
+void SelectTrace(FmuDriver& fmu, const std::filesystem::path& trace_path)
+{
+    fmu.SetString(kTracePath, trace_path.parent_path().string());
+    fmu.SetString(kTraceName, trace_path.filename().string());
+}
+
+/* Runs steps simulation steps of 100 ms and returns the published messages */
+std::vector<std::string> Play(FmuDriver& fmu, size_t steps)
+{
+    CHECK(fmu.Initialize() == fmi2OK);
+    std::vector<std::string> messages;
+    for (size_t step = 0; step < steps; step++)
+    {
+        CHECK(fmu.DoStep(static_cast<double>(step) * 0.1, 0.1) == fmi2OK);
+        CHECK(fmu.GetBoolean(kValid));
+        messages.push_back(fmu.Output(kSensorViewOut));
+    }
+    return messages;
+}
+
+void CheckSameRecords(const std::vector<std::string>& messages, const std::vector<std::string>& records)
+{
+    CHECK(messages.size() == records.size());
+    for (size_t frame = 0; frame < records.size(); frame++)
+    {
+        if (messages[frame] != records[frame])
+        {
+            std::fprintf(stderr, "Message %zu differs from the trace record\n", frame);
+        }
+        CHECK(messages[frame] == records[frame]);
+    }
+}
+
+void TestExampleTrace(const std::filesystem::path& example_trace)
+{
+    const auto records = ReadTraceRecords(example_trace);
+    CHECK(!records.empty());
+
+    FmuDriver fmu(g_library_path);
+    SelectTrace(fmu, example_trace);
+    CheckSameRecords(Play(fmu, records.size()), records);
+}
+
+void TestGeneratedTraces()
+{
+    for (const std::string name : {"playback_gt_generated.osi", "playback_sv_generated.osi"})
+    {
+        const auto trace_path = g_trace_dir / name;
+        const auto record_path = g_trace_dir / ("recorded_" + name);
+        const auto records = ReadTraceRecords(trace_path);
+        {
+            FmuDriver fmu(g_library_path);
+            SelectTrace(fmu, trace_path);
+            fmu.SetString(kRecordPath, record_path.string());
+            CheckSameRecords(Play(fmu, records.size()), records);
+        }
+        /* The recording is complete once the instance is freed */
+        CHECK(ReadFile(record_path) == ReadFile(trace_path));
+    }
+}
+
+void TestCorruptRecords()
+{
+    const auto records = ReadTraceRecords(g_trace_dir / "playback_gt_corrupt_expected.osi");
+
+    FmuDriver fmu(g_library_path);
+    SelectTrace(fmu, g_trace_dir / "playback_gt_corrupt.osi");
+    fmu.SetInteger(kOnCorruptRecord, 1);
+    CheckSameRecords(Play(fmu, records.size()), records);
+    CHECK(fmu.GetInteger(kSkippedRecords) == 1);
+}
+
+/* Delta-compressed traces exercise AppendGroundTruth() of the player */
+void TestDeltaCompressedTraces()
+{
+    const auto trace_path = g_trace_dir / "playback_gt_delta.osi";
+    const auto records = ReadTraceRecords(g_trace_dir / "playback_gt_prefixed_expected.osi");
+    {
+        FmuDriver fmu(g_library_path);
+        SelectTrace(fmu, trace_path);
+        fmu.SetString(kStaticTraceName, "playback_gt_static.osi");
+        CheckSameRecords(Play(fmu, records.size()), records);
+    }
+
+    for (const bool synthesize_sensor_view : {false, true})
+    {
+        const auto record_path = g_trace_dir / (synthesize_sensor_view ? "recorded_sv_delta_cached.osi" : "recorded_gt_delta_cached.osi");
+        FmuDriver fmu(g_library_path);
+        SelectTrace(fmu, trace_path);
+        fmu.SetString(kStaticTraceName, "playback_gt_static.osi");
+        fmu.SetBoolean(kCacheStaticContent, true);
+        fmu.SetBoolean(kSynthesizeSensorView, synthesize_sensor_view);
+        fmu.SetString(kRecordPath, record_path.string());
+        Play(fmu, records.size());
+    }
+}
+
+/* With steps of 50 ms, every frame of the trace is published on two steps */
+void TestInterpolatedEgoCoordinates()
+{
+    FmuDriver fmu(g_library_path);
+    SelectTrace(fmu, g_trace_dir / "playback_gt_generated.osi");
+    fmu.SetBoolean(kInterpolate, true);
+    fmu.SetBoolean(kEgoCoordinates, true);
+    fmu.SetString(kRecordPath, (g_trace_dir / "recorded_gt_ego_interpolated.osi").string());
+    CHECK(fmu.Initialize() == fmi2OK);
+    for (int step = 0; step < 40; step++)
+    {
+        CHECK(fmu.DoStep(step * 0.05, 0.05) == fmi2OK);
+        CHECK(fmu.GetBoolean(kValid));
+    }
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 4)
+    {
+        std::fprintf(stderr, "Usage: %s <FMU library> <example trace> <directory of generated traces>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    g_library_path = argv[1];
+    g_trace_dir = argv[3];
+
+    TestExampleTrace(argv[2]);
+    TestGeneratedTraces();
+    TestCorruptRecords();
+    TestDeltaCompressedTraces();
+    TestInterpolatedEgoCoordinates();
+    return EXIT_SUCCESS;
+}
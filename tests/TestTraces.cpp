@@ -0,0 +1,301 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Test Traces
+ *
+ * Generates the traces played by PlaybackTest and ThroughputTest, and
+ * compares recordings of the player with the expected GroundTruth frames.
+ * This is a separate program, as the FMU brings its own copy of the OSI
+ * messages, which must not be registered twice with a shared protobuf
+ * library in one process.
+ *
+ * The generated scenario has a configurable number of moving objects
+ * driving along straight lanes.  The static content, i.e. lanes, lane
+ * boundaries, stationary objects and a traffic sign, is the same in every
+ * frame.  Delta-compressed traces are generated by leaving out the static
+ * or the dynamic content.  The frames are 100 ms apart.
+ *
+ * Usage: TestTraces generate <directory>
+ *        TestTraces compare <recorded trace> <expected GroundTruth trace>
+ *        TestTraces compare-ego <recorded trace> <played GroundTruth trace>
+ *
+ * compare checks that every GroundTruth of the recorded trace, or the
+ * global_ground_truth of every SensorView for "_sv_" traces, equals the
+ * expected frame.  compare-ego checks a recording of interpolated playback
+ * in ego coordinates: the expected frame at the timestamp of each recorded
+ * frame is interpolated from the played trace and then transformed, both by
+ * the components of the player, which are tested on their own.
+ */
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "EgoTransform.h"
+#include "FrameInterpolator.h"
+#include "TestUtilities.h"
+#include "osi_groundtruth.pb.h"
+#include "osi_sensorview.pb.h"
+
+namespace
+{
+struct GroundTruthScenario
+{
+    int moving_objects = 8;
+    int lanes = 4;
+    int centerline_points = 20;
+    bool static_content = true;
+    bool dynamic_content = true;
+};
+
+void GenerateGroundTruth(const GroundTruthScenario& scenario, int frame, osi3::GroundTruth& ground_truth)
+{
+    ground_truth.Clear();
+    ground_truth.mutable_version()->set_version_major(3);
+    ground_truth.mutable_timestamp()->set_seconds(frame / 10);
+    ground_truth.mutable_timestamp()->set_nanos(static_cast<uint32_t>(frame % 10) * 100000000U);
+    ground_truth.mutable_host_vehicle_id()->set_value(1);
+
+    if (scenario.static_content)
+    {
+        for (int i = 0; i < scenario.lanes; i++)
+        {
+            auto* lane = ground_truth.add_lane();
+            lane->mutable_id()->set_value(1000 + i);
+            lane->mutable_classification()->set_type(2);
+            auto* boundary = ground_truth.add_lane_boundary();
+            boundary->mutable_id()->set_value(2000 + i);
+            for (int j = 0; j < scenario.centerline_points; j++)
+            {
+                auto* point = lane->mutable_classification()->add_centerline();
+                point->set_x(j * 5.0);
+                point->set_y(i * 3.5);
+                point->set_z(0.0);
+                auto* boundary_point = boundary->add_boundary_line();
+                boundary_point->mutable_position()->set_x(j * 5.0);
+                boundary_point->mutable_position()->set_y(i * 3.5 + 1.75);
+                boundary_point->mutable_position()->set_z(0.0);
+                boundary_point->set_width(0.15);
+            }
+            auto* stationary_object = ground_truth.add_stationary_object();
+            stationary_object->mutable_id()->set_value(3000 + i);
+            stationary_object->mutable_base()->mutable_position()->set_x(i * 25.0);
+            stationary_object->mutable_base()->mutable_position()->set_y(-5.0);
+            stationary_object->mutable_base()->mutable_dimension()->set_length(0.5);
+        }
+        auto* traffic_sign = ground_truth.add_traffic_sign();
+        traffic_sign->mutable_id()->set_value(4000);
+        traffic_sign->mutable_main_sign()->mutable_base()->mutable_position()->set_x(50.0);
+        traffic_sign->mutable_main_sign()->mutable_base()->mutable_position()->set_y(-4.0);
+    }
+
+    if (scenario.dynamic_content)
+    {
+        for (int i = 0; i < scenario.moving_objects; i++)
+        {
+            auto* moving_object = ground_truth.add_moving_object();
+            moving_object->mutable_id()->set_value(1 + i);
+            auto* base = moving_object->mutable_base();
+            base->mutable_dimension()->set_length(4.5);
+            base->mutable_dimension()->set_width(1.8);
+            base->mutable_dimension()->set_height(1.5);
+            base->mutable_position()->set_x(i * 10.0 + frame * (1.0 + 0.1 * i));
+            base->mutable_position()->set_y((i % 4) * 3.5);
+            base->mutable_position()->set_z(0.75);
+            base->mutable_orientation()->set_roll(0.0);
+            base->mutable_orientation()->set_pitch(0.0);
+            base->mutable_orientation()->set_yaw(0.01 * frame);
+            base->mutable_velocity()->set_x(10.0 + i);
+            base->mutable_velocity()->set_y(0.0);
+            base->mutable_velocity()->set_z(0.0);
+            moving_object->mutable_vehicle_attributes()->mutable_bbcenter_to_rear()->set_x(-1.4);
+        }
+        auto* traffic_light = ground_truth.add_traffic_light();
+        traffic_light->mutable_id()->set_value(5000);
+        traffic_light->mutable_base()->mutable_position()->set_x(60.0 + frame % 2);
+    }
+}
+
+std::vector<std::string> GenerateGroundTruthRecords(const GroundTruthScenario& scenario, int frames)
+{
+    std::vector<std::string> records;
+    osi3::GroundTruth ground_truth;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        GenerateGroundTruth(scenario, frame, ground_truth);
+        records.push_back(ground_truth.SerializeAsString());
+    }
+    return records;
+}
+
+std::vector<std::string> GenerateSensorViewRecords(const GroundTruthScenario& scenario, int frames)
+{
+    std::vector<std::string> records;
+    osi3::SensorView sensor_view;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        sensor_view.Clear();
+        GenerateGroundTruth(scenario, frame, *sensor_view.mutable_global_ground_truth());
+        sensor_view.mutable_version()->CopyFrom(sensor_view.global_ground_truth().version());
+        sensor_view.mutable_timestamp()->CopyFrom(sensor_view.global_ground_truth().timestamp());
+        sensor_view.mutable_host_vehicle_id()->set_value(1);
+        sensor_view.mutable_mounting_position()->mutable_position()->set_x(1.5);
+        records.push_back(sensor_view.SerializeAsString());
+    }
+    return records;
+}
+
+void Generate(const std::filesystem::path& directory)
+{
+    std::filesystem::create_directories(directory);
+
+    GroundTruthScenario scenario;
+    WriteTrace(directory / "playback_gt_generated.osi", GenerateGroundTruthRecords(scenario, 30));
+    WriteTrace(directory / "playback_sv_generated.osi", GenerateSensorViewRecords(scenario, 30));
+
+    /* A record whose payload is overwritten with 0xFF bytes, which does not
+     * parse, and the frames the player publishes when skipping it */
+    constexpr size_t kCorruptFrame = 7;
+    auto records = GenerateGroundTruthRecords(scenario, 20);
+    auto corrupt_records = records;
+    corrupt_records[kCorruptFrame].assign(corrupt_records[kCorruptFrame].size(), '\xFF');
+    records.erase(records.begin() + kCorruptFrame);
+    WriteTrace(directory / "playback_gt_corrupt.osi", corrupt_records);
+    WriteTrace(directory / "playback_gt_corrupt_expected.osi", records);
+
+    /* A delta-compressed trace with its static trace, the complete frames,
+     * and the static record followed by each frame as published */
+    constexpr int kDeltaFrames = 20;
+    WriteTrace(directory / "playback_gt_complete.osi", GenerateGroundTruthRecords(scenario, kDeltaFrames));
+    scenario.dynamic_content = false;
+    const auto static_records = GenerateGroundTruthRecords(scenario, 1);
+    WriteTrace(directory / "playback_gt_static.osi", static_records);
+    scenario.dynamic_content = true;
+    scenario.static_content = false;
+    const auto delta_records = GenerateGroundTruthRecords(scenario, kDeltaFrames);
+    WriteTrace(directory / "playback_gt_delta.osi", delta_records);
+    std::vector<std::string> prefixed_records;
+    for (const auto& record : delta_records)
+    {
+        prefixed_records.push_back(static_records.front() + record);
+    }
+    WriteTrace(directory / "playback_gt_prefixed_expected.osi", prefixed_records);
+
+    GroundTruthScenario large_scenario;
+    large_scenario.moving_objects = 200;
+    large_scenario.lanes = 100;
+    large_scenario.centerline_points = 50;
+    WriteTrace(directory / "throughput_gt_generated.osi", GenerateGroundTruthRecords(large_scenario, 200));
+}
+
+void Compare(const std::filesystem::path& recorded_trace, const std::filesystem::path& expected_trace)
+{
+    const bool sensor_view = recorded_trace.filename().string().find("_sv_") != std::string::npos;
+    const auto recorded_records = ReadTraceRecords(recorded_trace);
+    const auto expected_records = ReadTraceRecords(expected_trace);
+    CHECK(recorded_records.size() == expected_records.size());
+    for (size_t frame = 0; frame < expected_records.size(); frame++)
+    {
+        osi3::GroundTruth expected;
+        CHECK(expected.ParseFromString(expected_records[frame]));
+        osi3::GroundTruth recorded;
+        if (sensor_view)
+        {
+            osi3::SensorView recorded_sensor_view;
+            CHECK(recorded_sensor_view.ParseFromString(recorded_records[frame]));
+            recorded = recorded_sensor_view.global_ground_truth();
+        }
+        else
+        {
+            CHECK(recorded.ParseFromString(recorded_records[frame]));
+        }
+        if (!google::protobuf::util::MessageDifferencer::Equals(recorded, expected))
+        {
+            std::fprintf(stderr, "Frame %zu differs from the expected GroundTruth\n", frame);
+        }
+        CHECK(google::protobuf::util::MessageDifferencer::Equals(recorded, expected));
+    }
+}
+
+int64_t TimestampNanos(const osi3::Timestamp& timestamp)
+{
+    return timestamp.seconds() * 1000000000 + timestamp.nanos();
+}
+
+void CompareEgo(const std::filesystem::path& recorded_trace, const std::filesystem::path& played_trace)
+{
+    std::vector<osi3::GroundTruth> played_frames;
+    for (const auto& record : ReadTraceRecords(played_trace))
+    {
+        CHECK(played_frames.emplace_back().ParseFromString(record));
+    }
+    const auto recorded_records = ReadTraceRecords(recorded_trace);
+    CHECK(!recorded_records.empty() && !played_frames.empty());
+
+    FrameInterpolator interpolator;
+    EgoTransform transform;
+    google::protobuf::util::MessageDifferencer differencer;
+    differencer.set_float_comparison(google::protobuf::util::MessageDifferencer::APPROXIMATE);
+    size_t interpolated_frames = 0;
+    for (size_t frame = 0; frame < recorded_records.size(); frame++)
+    {
+        osi3::GroundTruth recorded;
+        CHECK(recorded.ParseFromString(recorded_records[frame]));
+        const int64_t time = TimestampNanos(recorded.timestamp());
+        size_t previous = 0;
+        while (previous + 1 < played_frames.size() && TimestampNanos(played_frames[previous + 1].timestamp()) <= time)
+        {
+            previous++;
+        }
+        const osi3::GroundTruth* next = previous + 1 < played_frames.size() ? &played_frames[previous + 1] : nullptr;
+        const int64_t previous_time = TimestampNanos(played_frames[previous].timestamp());
+        const double alpha = next != nullptr ? static_cast<double>(time - previous_time) / static_cast<double>(TimestampNanos(next->timestamp()) - previous_time) : 0.0;
+        interpolated_frames += alpha > 0.0 ? 1 : 0;
+
+        osi3::GroundTruth expected = played_frames[previous];
+        interpolator.Prepare(expected, next);
+        interpolator.Apply(expected, alpha);
+        expected.mutable_timestamp()->CopyFrom(recorded.timestamp());
+        CHECK(transform.Apply(expected, expected.host_vehicle_id().value()));
+        if (!differencer.Compare(recorded, expected))
+        {
+            std::fprintf(stderr, "Frame %zu differs from the expected GroundTruth in ego coordinates\n", frame);
+        }
+        CHECK(differencer.Compare(recorded, expected));
+    }
+    /* Frames between two trace frames are where a frame is published again */
+    CHECK(interpolated_frames > 0);
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc == 3 && std::string(argv[1]) == "generate")
+    {
+        Generate(argv[2]);
+        return EXIT_SUCCESS;
+    }
+    if (argc == 4 && std::string(argv[1]) == "compare")
+    {
+        Compare(argv[2], argv[3]);
+        return EXIT_SUCCESS;
+    }
+    if (argc == 4 && std::string(argv[1]) == "compare-ego")
+    {
+        CompareEgo(argv[2], argv[3]);
+        return EXIT_SUCCESS;
+    }
+    std::fprintf(stderr,
+                 "Usage: %s generate <directory>\n       %s compare <recorded trace> <expected GroundTruth trace>\n       %s compare-ego <recorded trace> <played GroundTruth trace>\n",
+                 argv[0],
+                 argv[0],
+                 argv[0]);
+    return EXIT_FAILURE;
+}
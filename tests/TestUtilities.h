@@ -0,0 +1,81 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+#ifndef TestUtilities_H_
+#define TestUtilities_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/*
+ * Test Utilities
+ *
+ * The tests are plain executables run by CTest.  CHECK() reports a failed
+ * condition and ends the test with a non-zero exit code.
+ *
+ * Binary .osi traces are written and read record by record: each record is
+ * the encoded message preceded by its size as 32 bit little-endian integer.
+ */
+
+#define CHECK(condition)                                                                       \
+    do                                                                                         \
+    {                                                                                          \
+        if (!(condition))                                                                      \
+        {                                                                                      \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            std::exit(EXIT_FAILURE);                                                           \
+        }                                                                                      \
+    } while (false)
+
+inline std::string RecordHeader(uint32_t size)
+{
+    const char header[4] = {static_cast<char>(size & 0xFFU),
+                            static_cast<char>((size >> 8U) & 0xFFU),
+                            static_cast<char>((size >> 16U) & 0xFFU),
+                            static_cast<char>((size >> 24U) & 0xFFU)};
+    return std::string(header, sizeof(header));
+}
+
+inline void WriteTrace(const std::filesystem::path& path, const std::vector<std::string>& records)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    for (const auto& record : records)
+    {
+        file << RecordHeader(static_cast<uint32_t>(record.size())) << record;
+    }
+    CHECK(file.good());
+}
+
+inline std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    CHECK(file.good());
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+inline std::vector<std::string> ReadTraceRecords(const std::filesystem::path& path)
+{
+    const std::string data = ReadFile(path);
+    std::vector<std::string> records;
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        CHECK(offset + 4 <= data.size());
+        const auto* header = reinterpret_cast<const unsigned char*>(data.data() + offset);
+        const size_t size = header[0] | (header[1] << 8U) | (header[2] << 16U) | (static_cast<uint32_t>(header[3]) << 24U);
+        CHECK(offset + 4 + size <= data.size());
+        records.push_back(data.substr(offset + 4, size));
+        offset += 4 + size;
+    }
+    return records;
+}
+
+#endif
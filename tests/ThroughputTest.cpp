@@ -0,0 +1,238 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Throughput Test
+ *
+ * Plays the GroundTruth trace with 200 moving objects and a large static
+ * road network generated by TestTraces through the FMU and compares the step
+ * statistics of the player against the baselines in throughput_baseline.txt.
+ *
+ * The mean step time is not compared in absolute terms, but relative to a
+ * reference loop run in the same process right before the player: the loop
+ * reads the records of the same trace, copies each into an output buffer and
+ * hashes it, i.e. the work any playback has to do per frame besides decoding
+ * and encoding.  This ratio may exceed its baseline by the given tolerance.
+ *
+ * Heap allocations are counted by replacing the global operator new of this
+ * executable, which the FMU library resolves to as well on ELF platforms.
+ * The mean number of allocations per step without the first step, rounded
+ * to whole allocations, and the number of output buffer reallocations
+ * reported by the FMU must not exceed their baselines.  Where the FMU does
+ * not use the operator new of the executable, e.g. on Windows, no
+ * allocations are seen and they are not checked.  The measured values are
+ * printed in the format of the baseline file.
+ *
+ * The baselines hold for optimized builds, so the test is skipped for
+ * Debug builds.
+ *
+ * Usage: ThroughputTest <FMU library> <directory of generated traces> <baseline file> <build configuration>
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "FmuDriver.h"
+#include "FrameHash.h"
+#include "TestUtilities.h"
+
+using namespace PlayerVariables;
+
+namespace
+{
+std::atomic<uint64_t> heap_allocations{0};
+}  // namespace
+
+void* operator new(size_t size)
+{
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* const memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t /*size*/) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t /*size*/) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+constexpr int kSkipped = 77;
+constexpr int kReferenceRuns = 3;
+
+struct Baseline
+{
+    double relative_step_time = 0.0;
+    double heap_allocations_per_step = 0.0;
+    int output_buffer_reallocations = 0;
+};
+
+/* Reads "tolerance <fraction>" and "<configuration> <relative step time>
+ * <heap allocations per step> <output buffer reallocations>" lines, ignoring
+ * comments */
+void ReadBaselines(const std::filesystem::path& path, double& tolerance, std::map<std::string, Baseline>& baselines)
+{
+    std::ifstream file(path);
+    CHECK(file.good());
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name) || name[0] == '#')
+        {
+            continue;
+        }
+        if (name == "tolerance")
+        {
+            CHECK(fields >> tolerance);
+            continue;
+        }
+        Baseline baseline;
+        CHECK(fields >> baseline.relative_step_time >> baseline.heap_allocations_per_step >> baseline.output_buffer_reallocations);
+        baselines[name] = baseline;
+    }
+}
+
+/* Mean time per frame in s of the reference loop, the fastest of a few runs */
+double MeasureReference(const std::filesystem::path& trace_path)
+{
+    double fastest = 0.0;
+    for (int run = 0; run < kReferenceRuns; run++)
+    {
+        std::ifstream file(trace_path, std::ios::binary);
+        CHECK(file.good());
+        std::string record;
+        std::string buffer;
+        uint64_t digest = 0;
+        size_t frames = 0;
+        const auto start = std::chrono::steady_clock::now();
+        char header[4];
+        while (file.read(header, sizeof(header)))
+        {
+            const auto* const size_bytes = reinterpret_cast<const unsigned char*>(header);
+            const size_t size = size_bytes[0] | (size_bytes[1] << 8U) | (size_bytes[2] << 16U) | (static_cast<uint32_t>(size_bytes[3]) << 24U);
+            record.resize(size);
+            CHECK(file.read(&record[0], static_cast<std::streamsize>(size)));
+            buffer.assign(record);
+            digest ^= FrameHash(buffer.data(), buffer.size());
+            frames++;
+        }
+        const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(frames);
+        std::printf("Reference loop: %.1f us per frame (digest %016llx)\n", time * 1e6, static_cast<unsigned long long>(digest));
+        if (run == 0 || time < fastest)
+        {
+            fastest = time;
+        }
+    }
+    return fastest;
+}
+
+Baseline Measure(const std::filesystem::path& library_path, const std::filesystem::path& trace_path, size_t frames, bool cache_static_content)
+{
+    const double reference_time = MeasureReference(trace_path);
+
+    FmuDriver fmu(library_path);
+    fmu.SetString(kTracePath, trace_path.parent_path().string());
+    fmu.SetString(kTraceName, trace_path.filename().string());
+    fmu.SetBoolean(kCacheStaticContent, cache_static_content);
+    CHECK(fmu.Initialize() == fmi2OK);
+    CHECK(frames > 1);
+    CHECK(fmu.DoStep(0.0, 0.1) == fmi2OK);
+    const uint64_t first_allocations = heap_allocations.load();
+    for (size_t step = 1; step < frames; step++)
+    {
+        CHECK(fmu.DoStep(static_cast<double>(step) * 0.1, 0.1) == fmi2OK);
+    }
+    Baseline measured;
+    measured.heap_allocations_per_step = static_cast<double>(heap_allocations.load() - first_allocations) / static_cast<double>(frames - 1);
+    measured.relative_step_time = fmu.GetReal(kMeanStepTime) / reference_time;
+    measured.output_buffer_reallocations = fmu.GetInteger(kOutputBufferReallocations);
+    return measured;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 5)
+    {
+        std::fprintf(stderr, "Usage: %s <FMU library> <directory of generated traces> <baseline file> <build configuration>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (std::string(argv[4]) == "Debug")
+    {
+        std::printf("Skipped, the baselines hold for optimized builds\n");
+        return kSkipped;
+    }
+
+    double tolerance = 0.0;
+    std::map<std::string, Baseline> baselines;
+    ReadBaselines(argv[3], tolerance, baselines);
+
+    const auto trace_path = std::filesystem::path(argv[2]) / "throughput_gt_generated.osi";
+    const size_t frames = ReadTraceRecords(trace_path).size();
+
+    bool passed = true;
+    for (const bool cache_static_content : {false, true})
+    {
+        const std::string configuration = cache_static_content ? "cache_static_content" : "playback";
+        const auto baseline = baselines.find(configuration);
+        CHECK(baseline != baselines.end());
+        const Baseline measured = Measure(argv[1], trace_path, frames, cache_static_content);
+        std::printf("%s %.1f %.0f %d\n", configuration.c_str(), measured.relative_step_time, measured.heap_allocations_per_step, measured.output_buffer_reallocations);
+        if (measured.relative_step_time > baseline->second.relative_step_time * (1.0 + tolerance))
+        {
+            std::fprintf(stderr, "%s: mean step time of %.1f times the reference loop exceeds the baseline of %.1f\n", configuration.c_str(), measured.relative_step_time, baseline->second.relative_step_time);
+            passed = false;
+        }
+        if (measured.heap_allocations_per_step == 0.0)
+        {
+            std::printf("%s: heap allocations of the FMU are not seen on this platform and not checked\n", configuration.c_str());
+        }
+        else if (std::round(measured.heap_allocations_per_step) > baseline->second.heap_allocations_per_step)
+        {
+            std::fprintf(stderr, "%s: %.0f heap allocations per step exceed the baseline of %.0f\n", configuration.c_str(), measured.heap_allocations_per_step, baseline->second.heap_allocations_per_step);
+            passed = false;
+        }
+        if (measured.output_buffer_reallocations > baseline->second.output_buffer_reallocations)
+        {
+            std::fprintf(stderr, "%s: %d output buffer reallocations exceed the baseline of %d\n", configuration.c_str(), measured.output_buffer_reallocations, baseline->second.output_buffer_reallocations);
+            passed = false;
+        }
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
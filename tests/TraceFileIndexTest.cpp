@@ -0,0 +1,222 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Trace File Index Test
+ *
+ * Builds the index of a generated GroundTruth trace and checks the offset,
+ * size and timestamp of every frame, including frames without timestamp and
+ * a frame whose timestamp lies behind the leading bytes.  Then checks
+ * timestamp range lookups, reads by frame number and by range through a
+ * cursor, and several cursors reading the same index concurrently.
+ *
+ * Usage: TraceFileIndexTest <directory for generated traces>
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestUtilities.h"
+#include "TraceFileAccess.h"
+#include "osi_groundtruth.pb.h"
+
+namespace
+{
+constexpr int kFrames = 60;
+constexpr int kUntimedFrameInterval = 7;
+constexpr int kLateTimestampFrame = 22;
+constexpr int64_t kFrameTimeNs = 100000000;
+constexpr int kCursorThreads = 8;
+
+struct IndexedTrace
+{
+    std::filesystem::path path;
+    std::vector<std::string> records;
+    std::vector<uint64_t> offsets;
+    std::vector<int64_t> timestamps;
+};
+
+osi3::GroundTruth Frame(int frame)
+{
+    osi3::GroundTruth ground_truth;
+    ground_truth.mutable_version()->set_version_major(3);
+    for (int i = 0; i < 20; i++)
+    {
+        auto* const moving_object = ground_truth.add_moving_object();
+        moving_object->mutable_id()->set_value(frame * 100 + i);
+        moving_object->mutable_base()->mutable_position()->set_x(frame + i * 0.5);
+    }
+    return ground_truth;
+}
+
+/* Every kUntimedFrameInterval-th frame has no timestamp and inherits the one
+ * of the previous frame.  The timestamp of kLateTimestampFrame is encoded
+ * behind the moving objects, which concatenated encodings merge into one
+ * message, so that the index has to scan the whole frame for it. */
+IndexedTrace WriteIndexedTrace(const std::filesystem::path& directory)
+{
+    IndexedTrace trace;
+    trace.path = directory / "file_access_gt_index.osi";
+    uint64_t offset = 0;
+    int64_t timestamp = 0;
+    for (int frame = 0; frame < kFrames; frame++)
+    {
+        osi3::GroundTruth ground_truth = Frame(frame);
+        osi3::GroundTruth timestamp_only;
+        if (frame % kUntimedFrameInterval != kUntimedFrameInterval - 1)
+        {
+            timestamp = frame * kFrameTimeNs;
+            auto* const frame_timestamp = frame == kLateTimestampFrame ? timestamp_only.mutable_timestamp() : ground_truth.mutable_timestamp();
+            frame_timestamp->set_seconds(timestamp / 1000000000);
+            frame_timestamp->set_nanos(static_cast<uint32_t>(timestamp % 1000000000));
+        }
+        trace.records.push_back(ground_truth.SerializeAsString() + timestamp_only.SerializeAsString());
+        trace.offsets.push_back(offset + 4);
+        trace.timestamps.push_back(timestamp);
+        offset += 4 + trace.records.back().size();
+    }
+    CHECK(trace.records[kLateTimestampFrame].size() > 256);
+    WriteTrace(trace.path, trace.records);
+    return trace;
+}
+
+bool Equals(const google::protobuf::Message& message, const std::string& record)
+{
+    osi3::GroundTruth expected;
+    return expected.ParseFromString(record) && message.SerializeAsString() == expected.SerializeAsString();
+}
+
+void TestBuild(const IndexedTrace& trace, const TraceFileIndex& index)
+{
+    CHECK(index.TracePath() == trace.path);
+    CHECK(index.MessageType() == osi3::ReaderTopLevelMessage::kGroundTruth);
+    CHECK(index.FrameCount() == trace.records.size());
+    for (size_t frame = 0; frame < index.FrameCount(); frame++)
+    {
+        CHECK(index[frame].offset == trace.offsets[frame]);
+        CHECK(index[frame].size == trace.records[frame].size());
+        CHECK(index[frame].timestamp == trace.timestamps[frame]);
+    }
+
+    /* Random access needs a binary .osi trace whose name tells the type */
+    const auto unknown_type_path = trace.path.parent_path() / "file_access_index.osi";
+    WriteTrace(unknown_type_path, trace.records);
+    CHECK(TraceFileIndex::Build(unknown_type_path) == nullptr);
+    CHECK(TraceFileIndex::Build(trace.path.parent_path() / "file_access_gt_index.mcap") == nullptr);
+}
+
+void TestFrameRange(const IndexedTrace& trace, const TraceFileIndex& index)
+{
+    using Range = std::pair<size_t, size_t>;
+    const auto frames = static_cast<size_t>(kFrames);
+    CHECK(index.FrameRange(0, kFrames * kFrameTimeNs) == Range(0, frames));
+    CHECK(index.FrameRange(-2 * kFrameTimeNs, -kFrameTimeNs) == Range(0, 0));
+    CHECK(index.FrameRange(kFrames * kFrameTimeNs, (kFrames + 1) * kFrameTimeNs) == Range(frames, frames));
+    CHECK(index.FrameRange(3 * kFrameTimeNs, 3 * kFrameTimeNs) == Range(3, 4));
+    CHECK(index.FrameRange(3 * kFrameTimeNs + 1, 4 * kFrameTimeNs - 1) == Range(4, 4));
+
+    /* Untimed frames belong to the timestamp they inherit */
+    const size_t untimed = kUntimedFrameInterval - 1;
+    CHECK(index.FrameRange(trace.timestamps[untimed], trace.timestamps[untimed]) == Range(untimed - 1, untimed + 1));
+    CHECK(index.FrameRange(trace.timestamps[untimed] + 1, trace.timestamps[untimed + 1]) == Range(untimed + 1, untimed + 2));
+}
+
+void TestCursor(const IndexedTrace& trace, const std::shared_ptr<const TraceFileIndex>& index)
+{
+    TraceFileCursor cursor(index);
+    CHECK(&cursor.Index() == index.get());
+    for (size_t frame = trace.records.size(); frame-- > 0;)
+    {
+        const auto message = cursor.Read(frame);
+        CHECK(message != nullptr);
+        CHECK(Equals(*message, trace.records[frame]));
+    }
+    osi3::GroundTruth ground_truth;
+    CHECK(cursor.Read(kLateTimestampFrame, ground_truth));
+    CHECK(ground_truth.timestamp().seconds() * 1000000000 + ground_truth.timestamp().nanos() == trace.timestamps[kLateTimestampFrame]);
+    CHECK(!cursor.Read(trace.records.size(), ground_truth));
+    CHECK(cursor.Read(trace.records.size()) == nullptr);
+
+    const int64_t first_timestamp = 10 * kFrameTimeNs;
+    const int64_t last_timestamp = 30 * kFrameTimeNs;
+    const auto range = index->FrameRange(first_timestamp, last_timestamp);
+    std::vector<size_t> visited;
+    CHECK(cursor.ForEachInRange(first_timestamp, last_timestamp, [&](size_t frame, const google::protobuf::Message& message) {
+        CHECK(Equals(message, trace.records[frame]));
+        visited.push_back(frame);
+        return true;
+    }));
+    CHECK(visited.size() == range.second - range.first);
+    for (size_t i = 0; i < visited.size(); i++)
+    {
+        CHECK(visited[i] == range.first + i);
+    }
+
+    visited.clear();
+    CHECK(cursor.ForEachInRange(first_timestamp, last_timestamp, [&](size_t frame, const google::protobuf::Message& /*message*/) {
+        visited.push_back(frame);
+        return visited.size() < 3;
+    }));
+    CHECK(visited.size() == 3);
+}
+
+/* Each thread reads all frames through its own cursor, starting at a
+ * different frame, so that the cursors seek to different offsets at the
+ * same time.  Mismatches are counted per thread, as CHECK() must not end
+ * the process from a worker thread. */
+void TestConcurrentCursors(const IndexedTrace& trace, const std::shared_ptr<const TraceFileIndex>& index)
+{
+    std::vector<int> mismatches(kCursorThreads, 0);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < kCursorThreads; thread++)
+    {
+        threads.emplace_back([&, thread]() {
+            TraceFileCursor cursor(index);
+            osi3::GroundTruth ground_truth;
+            for (int pass = 0; pass < 5; pass++)
+            {
+                for (size_t i = 0; i < trace.records.size(); i++)
+                {
+                    const size_t frame = (i + static_cast<size_t>(thread) * 7) % trace.records.size();
+                    if (!cursor.Read(frame, ground_truth) || !Equals(ground_truth, trace.records[frame]))
+                    {
+                        mismatches[thread]++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (const int thread_mismatches : mismatches)
+    {
+        CHECK(thread_mismatches == 0);
+    }
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s <directory for generated traces>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::filesystem::create_directories(argv[1]);
+
+    const IndexedTrace trace = WriteIndexedTrace(argv[1]);
+    const auto index = TraceFileIndex::Build(trace.path);
+    CHECK(index != nullptr);
+    TestBuild(trace, *index);
+    TestFrameRange(trace, *index);
+    TestCursor(trace, index);
+    TestConcurrentCursors(trace, index);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+//
+// Copyright 2026 Persival GmbH
+// SPDX-License-Identifier: MPL-2.0
+//
+
+/*
+ * Trace Record Reader Test
+ *
+ * Reads a GroundTruth trace with random bytes between two records and
+ * checks that Resync() continues exactly at the next record, and that a
+ * trace ending in random bytes offers no further record.
+ *
+ * Usage: TraceRecordReaderTest <directory for generated traces>
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TestUtilities.h"
+#include "TraceFileAccess.h"
+#include "osi_groundtruth.pb.h"
+
+namespace
+{
+constexpr int kFrames = 30;
+constexpr int kGarbageFrame = 11;
+
+std::string Garbage(size_t size)
+{
+    std::mt19937 generator(7);
+    std::string garbage(size, '\0');
+    for (char& byte : garbage)
+    {
+        byte = static_cast<char>(generator());
+    }
+    return garbage;
+}
+
+std::string Frame(int frame)
+{
+    osi3::GroundTruth ground_truth;
+    ground_truth.mutable_version()->set_version_major(3);
+    ground_truth.mutable_timestamp()->set_seconds(frame);
+    for (int i = 0; i < 50; i++)
+    {
+        ground_truth.add_moving_object()->mutable_id()->set_value(frame + i);
+    }
+    return ground_truth.SerializeAsString();
+}
+
+int64_t Timestamp(const osi3::ReadResult& result)
+{
+    return static_cast<const osi3::GroundTruth&>(*result.message).timestamp().seconds();
+}
+
+void TestResync(const std::filesystem::path& directory)
+{
+    const auto trace_path = directory / "record_reader_gt_resync.osi";
+    std::vector<std::string> records;
+    std::vector<uint64_t> offsets;
+    std::string trace;
+    for (int frame = 0; frame < kFrames; frame++)
+    {
+        if (frame == kGarbageFrame)
+        {
+            trace += Garbage(200000);
+        }
+        records.push_back(Frame(frame));
+        offsets.push_back(trace.size());
+        trace += RecordHeader(static_cast<uint32_t>(records.back().size())) + records.back();
+    }
+    std::ofstream(trace_path, std::ios::binary) << trace;
+
+    TraceRecordReader reader(osi3::ReaderTopLevelMessage::kGroundTruth, 0);
+    CHECK(reader.Open(trace_path));
+    for (int frame = 0; frame < kGarbageFrame; frame++)
+    {
+        const auto result = reader.ReadMessage();
+        CHECK(result.has_value());
+        CHECK(Timestamp(*result) == frame);
+        CHECK(reader.Record() == records[frame]);
+    }
+    const uint64_t garbage_offset = reader.Offset();
+    CHECK(!reader.ReadMessage().has_value());
+    CHECK(reader.Offset() == garbage_offset);
+
+    CHECK(reader.Resync());
+    CHECK(reader.Offset() == offsets[kGarbageFrame]);
+    for (int frame = kGarbageFrame; frame < kFrames; frame++)
+    {
+        const auto result = reader.ReadMessage();
+        CHECK(result.has_value());
+        CHECK(Timestamp(*result) == frame);
+    }
+    CHECK(!reader.HasNext());
+}
+
+void TestResyncAtEnd(const std::filesystem::path& directory)
+{
+    const auto trace_path = directory / "record_reader_gt_tail.osi";
+    const std::string record = Frame(0);
+    std::ofstream(trace_path, std::ios::binary) << RecordHeader(static_cast<uint32_t>(record.size())) << record << Garbage(5000);
+
+    TraceRecordReader reader(osi3::ReaderTopLevelMessage::kGroundTruth, 0);
+    CHECK(reader.Open(trace_path));
+    CHECK(reader.ReadMessage().has_value());
+    CHECK(!reader.ReadMessage().has_value());
+    CHECK(!reader.Resync());
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s <directory for generated traces>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    std::filesystem::create_directories(argv[1]);
+
+    TestResync(argv[1]);
+    TestResyncAtEnd(argv[1]);
+    return EXIT_SUCCESS;
+}